@@ -30,9 +30,53 @@
 #include <string>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 
 #include "raylib.h"
 #include "raymath.h"
+#include "rlgl.h"
+
+// Kernels SIMD das paredes: SSE2 é garantido em x86-64; AVX2 é escolhido em
+// tempo de execução quando a CPU suporta. Em outras arquiteturas só existe a
+// versão escalar.
+#if defined(__GNUC__) && defined(__SSE2__)
+#define LABIRINTO_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// Mapeamento de arquivos em memória e tempo de CPU do processo (benchmarks).
+// No Windows as funções da API são declaradas aqui mesmo, porque <windows.h>
+// conflita com nomes da raylib (Rectangle, CloseWindow, DrawText, ...).
+#if defined(_WIN32)
+extern "C" {
+__declspec(dllimport) void* __stdcall CreateFileA(const char* name, unsigned long access, unsigned long share, void* security, unsigned long creation, unsigned long flags, void* templateFile);
+__declspec(dllimport) int __stdcall GetFileSizeEx(void* file, long long* size);
+__declspec(dllimport) void* __stdcall CreateFileMappingA(void* file, void* security, unsigned long protect, unsigned long sizeHigh, unsigned long sizeLow, const char* name);
+__declspec(dllimport) void* __stdcall MapViewOfFile(void* mapping, unsigned long access, unsigned long offsetHigh, unsigned long offsetLow, size_t bytes);
+__declspec(dllimport) int __stdcall UnmapViewOfFile(const void* address);
+__declspec(dllimport) int __stdcall CloseHandle(void* handle);
+__declspec(dllimport) void* __stdcall GetCurrentProcess(void);
+__declspec(dllimport) int __stdcall GetProcessTimes(void* process, unsigned long long* creation, unsigned long long* exit, unsigned long long* kernel, unsigned long long* user);
+}
+#else
+#include <time.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 // =============================================================================
 //                          FUNÇÕES DE PONTE PARA RAYMATH
@@ -58,6 +102,26 @@ static inline Vector2 MyVector2Scale(Vector2 v, float scale) {
 const int SCREEN_WIDTH = 1280;
 const int SCREEN_HEIGHT = 960;
 
+// Frequência fixa da simulação (ticks por segundo) e limite de ticks de
+// recuperação por frame, para o jogo não "espiralar" após um travamento longo.
+const float DEFAULT_TICK_RATE = 120.0f;
+const int MAX_CATCHUP_STEPS = 8;
+
+// Telas paradas (menu, pausa, fim de jogo) são desenhadas a IDLE_FPS quando
+// nada anima e ninguém mexe no mouse ou teclado há IDLE_GRACE_SECONDS.
+const int IDLE_FPS = 15;
+const float IDLE_GRACE_SECONDS = 1.0f;
+
+// Tamanho (em frames de áudio) dos buffers do stream de música. Precisa cobrir
+// com folga o intervalo entre frames a IDLE_FPS para a música não engasgar.
+const int MUSIC_BUFFER_FRAMES = 8192;
+
+// Menor bloco de entidades mandado para outra thread pelo JobSystem. Abaixo
+// disso acordar uma thread custa mais do que o trabalho; os níveis normais
+// ficam abaixo e rodam inteiros na thread principal. Múltiplo de 32 para os
+// blocos de paredes não dividirem palavras do hitMask.
+const size_t JOB_GRAIN = 2048;
+
 // =============================================================================
 //                             DEFINIÇÃO DE CORES
 // =============================================================================
@@ -102,6 +166,455 @@ enum class GameState { MENU, PLAYING, PAUSED, LEVEL_TRANSITION, VICTORY, GAMEOVE
 // Define os diferentes bônus que o jogador pode coletar.
 enum class PowerUpType { LIFE, SHIELD, SPEED };
 
+// =============================================================================
+//                              ENTRADA DO JOGADOR
+// =============================================================================
+
+// Estado da entrada de um único tick de simulação. A lógica do jogo nunca lê o
+// teclado diretamente: quem roda a simulação (janela, bot headless, replay)
+// preenche esta estrutura e a entrega para o núcleo de simulação.
+struct InputState {
+    bool up = false;
+    bool down = false;
+    bool left = false;
+    bool right = false;
+
+    // Indica se alguma direção está pressionada (usado para o rastro do jogador).
+    bool Moving() const { return up || down || left || right; }
+
+    // Forma compacta (um bit por direção), usada nos replays.
+    uint8_t ToBits() const {
+        return (uint8_t)((up ? 1 : 0) | (down ? 2 : 0) | (left ? 4 : 0) | (right ? 8 : 0));
+    }
+
+    static InputState FromBits(uint8_t bits) {
+        InputState input;
+        input.up = (bits & 1) != 0;
+        input.down = (bits & 2) != 0;
+        input.left = (bits & 4) != 0;
+        input.right = (bits & 8) != 0;
+        return input;
+    }
+};
+
+// Lê o teclado e converte para um InputState. Só pode ser chamada com a janela aberta.
+static InputState ReadKeyboardInput() {
+    InputState input;
+    input.up = IsKeyDown(KEY_W) || IsKeyDown(KEY_UP);
+    input.down = IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN);
+    input.left = IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT);
+    input.right = IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT);
+    return input;
+}
+
+// =============================================================================
+//                        GERADOR DE NÚMEROS ALEATÓRIOS
+// =============================================================================
+
+// Sequências independentes do PCG32. Cada subsistema sorteia da sua, então
+// mudar a quantidade de partículas ou o tremor da tela não altera em nada a
+// aleatoriedade da partida (e os replays continuam válidos).
+enum class RandomStream : uint64_t {
+    GAMEPLAY = 1,   // simulação: moedas e power-ups
+    PARTICLES = 2,  // cosmético: direção, vida e tamanho das partículas
+    CAMERA = 3,     // cosmético: tremor da tela
+};
+
+// Gerador PCG32 com semente e sequência próprias, no lugar do GetRandomValue
+// global do raylib: é mais rápido por chamada e não mistura as sequências de
+// subsistemas diferentes. A mesma semente e as mesmas entradas sempre produzem
+// a mesma partida, o que permite gravar e reproduzir replays.
+class Random {
+public:
+    explicit Random(uint64_t seed = 0, RandomStream stream = RandomStream::GAMEPLAY) { Seed(seed, stream); }
+
+    void Seed(uint64_t seed, RandomStream stream = RandomStream::GAMEPLAY) {
+        state = 0;
+        inc = ((uint64_t)stream << 1u) | 1u;
+        Next();
+        state += seed;
+        Next();
+    }
+
+    uint32_t Next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + inc;
+        uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+        uint32_t rot = (uint32_t)(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    }
+
+    // Inteiro em [lo, hi], com os dois extremos inclusos (como GetRandomValue).
+    int Int(int lo, int hi) {
+        if (lo > hi) std::swap(lo, hi);
+        uint32_t range = (uint32_t)hi - (uint32_t)lo + 1u;
+        if (range == 0) return (int)Next();
+        // Descarta o início da faixa para que o módulo não favoreça os menores valores.
+        uint32_t threshold = (0u - range) % range;
+        uint32_t r;
+        do { r = Next(); } while (r < threshold);
+        return lo + (int)(r % range);
+    }
+
+    // Real uniforme em [0, 1), com 24 bits de precisão.
+    float Float() { return (Next() >> 8) * (1.0f / 16777216.0f); }
+
+    // Preenche 'out' com 'n' reais uniformes em [lo, hi). Usado para sortear
+    // em bloco os atributos de uma rajada de partículas.
+    void FillFloat(float* out, size_t n, float lo, float hi) {
+        float scale = (hi - lo) * (1.0f / 16777216.0f);
+        for (size_t i = 0; i < n; i++) out[i] = lo + (Next() >> 8) * scale;
+    }
+
+private:
+    uint64_t state = 0;
+    uint64_t inc = 1;
+};
+
+// =============================================================================
+//                            PERFILADOR DE FRAMES
+// =============================================================================
+
+// Fases medidas em cada frame. Fases executadas várias vezes no mesmo frame
+// (ex.: vários ticks da simulação) têm os tempos somados.
+enum class ProfilePhase {
+    FRAME,          // frame inteiro, de um início de frame ao próximo
+    UPDATE,         // Game::Update
+    SIM_TICK,       // ticks da simulação (UpdatePlaying)
+    SIM_POWERUPS,   //   timers, surgimento e coleta de power-ups
+    SIM_COINS,      //   coleta de moedas
+    SIM_WALLS,      //   movimento e colisão das paredes
+    PARTICLES,      // ParticleSystem::Update
+    DRAW,           // Game::Draw, incluindo a espera do EndDrawing (vsync)
+    DRAW_FOG,       //   névoa
+    DRAW_STARS,     //   estrelas
+    DRAW_ENTITIES,  //   jogador, paredes, moedas, power-ups e partículas
+    DRAW_HUD,       //   HUD e textos das telas
+    COUNT
+};
+
+static const char* const PROFILE_PHASE_NAMES[(int)ProfilePhase::COUNT] = {
+    "frame", "update", "sim_tick", "sim_powerups", "sim_coins", "sim_walls",
+    "particles", "draw", "draw_fog", "draw_stars", "draw_entities", "draw_hud",
+};
+
+// Guarda o tempo de cada fase nos últimos HISTORY frames em um buffer
+// circular. Os tempos de desenho são de CPU (envio dos comandos); o trabalho
+// da GPU aparece no tempo do EndDrawing, dentro de "draw". Só mede quando
+// 'active' é verdadeiro, então o modo headless não paga nada por ele.
+// As fases da simulação são medidas na thread de simulação e do pool de
+// jobs; cada frame soma o tempo que elas gastaram enquanto ele durou.
+class FrameProfiler {
+public:
+    static constexpr int HISTORY = 600;
+    static constexpr int PHASES = (int)ProfilePhase::COUNT;
+
+    // Lido também pelas threads de simulação e do pool (ProfileScope).
+    std::atomic<bool> active{ false };
+    bool overlayVisible = false;
+
+    using Clock = std::chrono::steady_clock;
+
+    // Fecha o frame anterior (gravando-o no buffer) e começa um novo.
+    void BeginFrame() {
+        if (!active.load(std::memory_order_relaxed)) return;
+        Clock::time_point now = Clock::now();
+        if (frameStarted) {
+            current[(int)ProfilePhase::FRAME].store(std::chrono::duration<float, std::milli>(now - frameStart).count(), std::memory_order_relaxed);
+            for (int p = 0; p < PHASES; p++) samples[head][p] = current[p].exchange(0.0f, std::memory_order_relaxed);
+            head = (head + 1) % HISTORY;
+            filled = std::min(filled + 1, HISTORY);
+            totalFrames++;
+            if (++framesSinceStats >= STATS_INTERVAL) RefreshStats();
+        } else {
+            for (auto& t : current) t.store(0.0f, std::memory_order_relaxed);
+        }
+        frameStart = now;
+        frameStarted = true;
+    }
+
+    // Pode ser chamado de qualquer thread.
+    void Add(ProfilePhase phase, float ms) {
+        std::atomic<float>& slot = current[(int)phase];
+        float old = slot.load(std::memory_order_relaxed);
+        while (!slot.compare_exchange_weak(old, old + ms, std::memory_order_relaxed)) {}
+    }
+
+    // Percentil 'pct' (0 a 100) da fase nos frames guardados, em milissegundos.
+    float Percentile(ProfilePhase phase, float pct) const {
+        if (filled == 0) return 0.0f;
+        std::vector<float> values(filled);
+        for (int i = 0; i < filled; i++) values[i] = samples[i][(int)phase];
+        size_t k = std::min((size_t)(pct / 100.0f * filled), (size_t)filled - 1);
+        std::nth_element(values.begin(), values.begin() + k, values.end());
+        return values[k];
+    }
+
+    // Tabela com p50/p99 de cada fase, recalculada a cada STATS_INTERVAL frames.
+    void DrawOverlay() const {
+        if (!overlayVisible) return;
+        const int lineHeight = 18;
+        const int x = 10, y = 60;
+        DrawRectangle(x - 6, y - 6, 300, lineHeight * (PHASES + 1) + 12, Fade(BLACK, 0.75f));
+        DrawText("fase              p50 ms   p99 ms", x, y, 16, UI_TEXT_COLOR);
+        for (int p = 0; p < PHASES; p++) {
+            DrawText(TextFormat("%-16s %7.3f  %7.3f", PROFILE_PHASE_NAMES[p], p50[p], p99[p]), x, y + lineHeight * (p + 1), 16, UI_TEXT_COLOR);
+        }
+    }
+
+    // Grava os frames do buffer, do mais antigo ao mais recente, em CSV.
+    bool WriteCsv(const char* path) const {
+        std::ofstream out(path);
+        if (!out) return false;
+        out << "index";
+        for (int p = 0; p < PHASES; p++) out << "," << PROFILE_PHASE_NAMES[p];
+        out << "\n";
+        int oldest = (head - filled + HISTORY) % HISTORY;
+        for (int i = 0; i < filled; i++) {
+            const float* row = samples[(oldest + i) % HISTORY];
+            out << totalFrames - filled + i;
+            for (int p = 0; p < PHASES; p++) out << "," << row[p];
+            out << "\n";
+        }
+        return (bool)out;
+    }
+
+    // Grava um resumo (média, p50, p99 e máximo de cada fase) em JSON.
+    bool WriteJson(const char* path) const {
+        std::ofstream out(path);
+        if (!out) return false;
+        out << "{\n  \"frames\": " << filled << ",\n  \"phases\": {\n";
+        for (int p = 0; p < PHASES; p++) {
+            float sum = 0.0f, peak = 0.0f;
+            for (int i = 0; i < filled; i++) {
+                sum += samples[i][p];
+                peak = std::max(peak, samples[i][p]);
+            }
+            out << "    \"" << PROFILE_PHASE_NAMES[p] << "\": { \"mean_ms\": " << (filled ? sum / filled : 0.0f)
+                << ", \"p50_ms\": " << Percentile((ProfilePhase)p, 50) << ", \"p99_ms\": " << Percentile((ProfilePhase)p, 99)
+                << ", \"max_ms\": " << peak << " }" << (p + 1 < PHASES ? "," : "") << "\n";
+        }
+        out << "  }\n}\n";
+        return (bool)out;
+    }
+
+    int Frames() const { return filled; }
+
+private:
+    static constexpr int STATS_INTERVAL = 30;
+
+    float samples[HISTORY][PHASES] = {};
+    std::atomic<float> current[PHASES] = {};
+    float p50[PHASES] = {};
+    float p99[PHASES] = {};
+    int head = 0;
+    int filled = 0;
+    long long totalFrames = 0;
+    int framesSinceStats = 0;
+    bool frameStarted = false;
+    Clock::time_point frameStart;
+
+    void RefreshStats() {
+        framesSinceStats = 0;
+        if (!overlayVisible) return;
+        for (int p = 0; p < PHASES; p++) {
+            p50[p] = Percentile((ProfilePhase)p, 50);
+            p99[p] = Percentile((ProfilePhase)p, 99);
+        }
+    }
+};
+
+static FrameProfiler profiler;
+static const char* PROFILE_CSV_PATH = "perfil_frames.csv";
+static const char* PROFILE_JSON_PATH = "perfil_resumo.json";
+
+// Mede o tempo do escopo em que é criado e soma na fase do frame atual.
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfilePhase p) : phase(p), enabled(profiler.active.load(std::memory_order_relaxed)) {
+        if (enabled) start = FrameProfiler::Clock::now();
+    }
+    ~ProfileScope() {
+        if (enabled) profiler.Add(phase, std::chrono::duration<float, std::milli>(FrameProfiler::Clock::now() - start).count());
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfilePhase phase;
+    bool enabled;
+    FrameProfiler::Clock::time_point start;
+};
+
+// =============================================================================
+//                          AGENDADOR DE TAREFAS (JOBS)
+// =============================================================================
+
+// Tarefas pendentes de um lote: Submit() incrementa, o fim de cada tarefa
+// decrementa e JobSystem::Wait() espera chegar a zero.
+using JobCounter = std::atomic<int>;
+
+// Pool fixo de threads com uma fila de tarefas por thread e roubo de
+// trabalho: cada thread consome a própria fila pelo fim (a tarefa mais
+// recente, ainda quente no cache) e, quando ela esvazia, rouba pelo início da
+// fila de outra. A thread que chama Wait() não fica parada esperando: executa
+// tarefas até o lote terminar, o que permite submeter tarefas de dentro de
+// tarefas. A fila 0 é de quem não é thread do pool (a thread principal).
+class JobSystem {
+public:
+    // 'workers' threads de trabalho além da thread que chama Wait().
+    explicit JobSystem(unsigned int workers = DefaultWorkers()) : queues(workers + 1) {
+        for (unsigned int i = 0; i < workers; i++) threads.emplace_back([this, i] { WorkerLoop(i + 1); });
+    }
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Um núcleo fica para a thread principal, que também executa tarefas no Wait().
+    static unsigned int DefaultWorkers() {
+        return std::clamp(std::thread::hardware_concurrency(), 1u, 8u) - 1;
+    }
+
+    unsigned int WorkerCount() const { return (unsigned int)threads.size(); }
+
+    // Enfileira 'fn' na fila da thread atual, contando a tarefa em 'counter'.
+    void Submit(JobCounter& counter, std::function<void()> fn) {
+        counter.fetch_add(1, std::memory_order_relaxed);
+        WorkQueue& q = queues[LocalQueue()];
+        {
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.jobs.push_back({ std::move(fn), &counter });
+        }
+        {
+            // Incrementado sob o mutex de sono para nenhuma thread dormir
+            // entre conferir 'queued' e começar a esperar.
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queued.fetch_add(1, std::memory_order_relaxed);
+        }
+        wake.notify_one();
+    }
+
+    // Executa tarefas (próprias ou roubadas) até todas as de 'counter' terminarem.
+    void Wait(JobCounter& counter) {
+        size_t self = LocalQueue();
+        while (counter.load(std::memory_order_acquire) > 0) {
+            Job job;
+            if (TryTake(self, job)) Execute(job);
+            else std::this_thread::yield();
+        }
+    }
+
+private:
+    struct Job {
+        std::function<void()> fn;
+        JobCounter* counter = nullptr;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<WorkQueue> queues;
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<int> queued{ 0 };
+    bool stopping = false;
+
+    // Fila da thread atual neste pool (0 para threads de fora dele).
+    static inline thread_local const JobSystem* localSystem = nullptr;
+    static inline thread_local size_t localQueue = 0;
+
+    size_t LocalQueue() const { return localSystem == this ? localQueue : 0; }
+
+    void WorkerLoop(size_t self) {
+        localSystem = this;
+        localQueue = self;
+        while (true) {
+            Job job;
+            if (TryTake(self, job)) {
+                Execute(job);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_relaxed) > 0; });
+            if (stopping) return;
+        }
+    }
+
+    // Pega a tarefa mais recente da própria fila ou, se ela estiver vazia, a
+    // mais antiga da primeira outra fila que tiver alguma.
+    bool TryTake(size_t self, Job& job) {
+        for (size_t k = 0; k < queues.size(); k++) {
+            WorkQueue& q = queues[(self + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.jobs.empty()) continue;
+            if (k == 0) {
+                job = std::move(q.jobs.back());
+                q.jobs.pop_back();
+            } else {
+                job = std::move(q.jobs.front());
+                q.jobs.pop_front();
+            }
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    static void Execute(Job& job) {
+        job.fn();
+        job.counter->fetch_sub(1, std::memory_order_release);
+    }
+};
+
+// Divide [0, count) em blocos que começam em múltiplos de 'grain' e chama
+// 'fn(begin, end)' para cada um, no máximo um bloco por thread. Sem 'jobs', ou
+// com até 'grain' itens, roda tudo direto na thread atual, sem custo extra.
+template <typename Fn>
+static void ParallelFor(JobSystem* jobs, size_t count, size_t grain, Fn&& fn) {
+    size_t blocks = (count + grain - 1) / grain;
+    if (!jobs || jobs->WorkerCount() == 0 || blocks <= 1) {
+        if (count > 0) fn((size_t)0, count);
+        return;
+    }
+    size_t chunks = std::min(blocks, (size_t)jobs->WorkerCount() + 1);
+    size_t chunk = (blocks + chunks - 1) / chunks * grain;
+
+    JobCounter counter{ 0 };
+    for (size_t begin = chunk; begin < count; begin += chunk) {
+        size_t end = std::min(begin + chunk, count);
+        jobs->Submit(counter, [&fn, begin, end] { fn(begin, end); });
+    }
+    fn((size_t)0, std::min(chunk, count));
+    jobs->Wait(counter);
+}
+
+// Roda 'a' e 'b', que não podem depender um do outro, em paralelo: 'b' vai
+// para o pool e 'a' roda na thread atual. Sem 'jobs', roda um depois do outro.
+template <typename A, typename B>
+static void ParallelInvoke(JobSystem* jobs, A&& a, B&& b) {
+    if (!jobs || jobs->WorkerCount() == 0) {
+        a();
+        b();
+        return;
+    }
+    JobCounter counter{ 0 };
+    jobs->Submit(counter, [&b] { b(); });
+    a();
+    jobs->Wait(counter);
+}
+
 // =============================================================================
 //                             CLASSES DE ENTIDADES
 // =============================================================================
@@ -117,6 +630,53 @@ public:
     virtual void Draw() const { DrawRectangleRec(rect, GRAY); }
 };
 
+// Interpola linearmente a posição entre dois retângulos (usado no desenho
+// entre dois ticks da simulação de passo fixo).
+static inline Rectangle LerpRect(Rectangle from, Rectangle to, float alpha) {
+    return { from.x + (to.x - from.x) * alpha, from.y + (to.y - from.y) * alpha, to.width, to.height };
+}
+
+// Teste de colisão contínuo (swept AABB) entre dois retângulos que se movem
+// linearmente de 'aPrev' para 'aCur' e de 'bPrev' para 'bCur' durante um tick.
+// Trabalha no referencial de B: A se move com a velocidade relativa e o
+// instante de entrada/saída é calculado em cada eixo. Retorna true se houver
+// sobreposição em algum instante do tick e grava em 'toi' o primeiro instante
+// de contato, entre 0 (início do tick) e 1 (fim do tick).
+static bool SweptAABB(Rectangle aPrev, Rectangle aCur, Rectangle bPrev, Rectangle bCur, float* toi) {
+    float vx = (aCur.x - aPrev.x) - (bCur.x - bPrev.x);
+    float vy = (aCur.y - aPrev.y) - (bCur.y - bPrev.y);
+
+    float enterX, exitX, enterY, exitY;
+    if (vx == 0.0f) {
+        // Sem movimento relativo no eixo: ou sobrepõe o tick inteiro, ou nunca.
+        if (aPrev.x + aPrev.width <= bPrev.x || aPrev.x >= bPrev.x + bPrev.width) return false;
+        enterX = -INFINITY;
+        exitX = INFINITY;
+    } else {
+        float nearX = vx > 0 ? bPrev.x - (aPrev.x + aPrev.width) : (bPrev.x + bPrev.width) - aPrev.x;
+        float farX = vx > 0 ? (bPrev.x + bPrev.width) - aPrev.x : bPrev.x - (aPrev.x + aPrev.width);
+        enterX = nearX / vx;
+        exitX = farX / vx;
+    }
+    if (vy == 0.0f) {
+        if (aPrev.y + aPrev.height <= bPrev.y || aPrev.y >= bPrev.y + bPrev.height) return false;
+        enterY = -INFINITY;
+        exitY = INFINITY;
+    } else {
+        float nearY = vy > 0 ? bPrev.y - (aPrev.y + aPrev.height) : (bPrev.y + bPrev.height) - aPrev.y;
+        float farY = vy > 0 ? (bPrev.y + bPrev.height) - aPrev.y : bPrev.y - (aPrev.y + aPrev.height);
+        enterY = nearY / vy;
+        exitY = farY / vy;
+    }
+
+    float enter = std::max(enterX, enterY);
+    float exit = std::min(exitX, exitY);
+    if (enter >= exit || enter >= 1.0f || exit <= 0.0f) return false;
+
+    *toi = std::max(enter, 0.0f);
+    return true;
+}
+
 // Classe do Jogador
 class Player : public Entidade {
 public:
@@ -126,6 +686,7 @@ public:
     float speedBoostTimer;
     float baseSpeed;
     float currentSpeed;
+    Rectangle prevRect; // Posição no tick anterior, para interpolação no desenho.
 
     // Construtor: Inicializa a velocidade base e reseta o estado do jogador
     Player() {
@@ -142,10 +703,13 @@ public:
         currentSpeed = baseSpeed;
         // Posição inicial do jogador no canto esquerdo da tela
         rect = { (float)SCREEN_WIDTH / 20, (float)SCREEN_HEIGHT / 2.0f - 15, 30, 30 };
+        prevRect = rect;
     }
 
-    // Atualiza a lógica do jogador a cada frame.
-    void Update(float delta) override {
+    // Atualiza a lógica do jogador a cada tick, a partir da entrada recebida.
+    void Update(float delta, const InputState& input) {
+        prevRect = rect;
+
         // Decrementa os timers de efeitos.
         if (invincibilityTimer > 0) invincibilityTimer -= delta;
         if (shieldTimer > 0) shieldTimer -= delta;
@@ -156,11 +720,11 @@ public:
             }
         }
 
-        // Processa a entrada do teclado para movimento.
-        if (IsKeyDown(KEY_W) || IsKeyDown(KEY_UP)) rect.y -= currentSpeed * delta;
-        if (IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN)) rect.y += currentSpeed * delta;
-        if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT)) rect.x -= currentSpeed * delta;
-        if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT)) rect.x += currentSpeed * delta;
+        // Processa a entrada para movimento.
+        if (input.up) rect.y -= currentSpeed * delta;
+        if (input.down) rect.y += currentSpeed * delta;
+        if (input.left) rect.x -= currentSpeed * delta;
+        if (input.right) rect.x += currentSpeed * delta;
 
         // Garante que o jogador permaneça dentro dos limites da tela.
         if (rect.x < 0) rect.x = 0;
@@ -170,21 +734,24 @@ public:
     }
 
     // Desenha o jogador na tela
-    void Draw() const override {
+    void Draw() const override { DrawAt(rect); }
+
+    // Desenha o jogador no retângulo informado (posição interpolada entre ticks).
+    void DrawAt(Rectangle r) const {
         // Efeito de invencibilidade: alteração de cor e borda pulsante do player.
         if (invincibilityTimer > 0) {
             float blinkAlpha = (sinf(GetTime() * 30.0f) + 1.0f) / 2.0f;
-            DrawRectangleRec(rect, Fade(PLAYER_INVINCIBLE_COLOR, 0.5f + blinkAlpha * 0.5f));
-            DrawRectangleLinesEx(rect, 3, Fade(UI_WARNING_COLOR, blinkAlpha * 1.0f));
+            DrawRectangleRec(r, Fade(PLAYER_INVINCIBLE_COLOR, 0.5f + blinkAlpha * 0.5f));
+            DrawRectangleLinesEx(r, 3, Fade(UI_WARNING_COLOR, blinkAlpha * 1.0f));
         } else {
-            DrawRectangleRec(rect, PLAYER_COLOR);
-            DrawRectangleLinesEx(rect, 2, WALL_BORDER_COLOR);
+            DrawRectangleRec(r, PLAYER_COLOR);
+            DrawRectangleLinesEx(r, 2, WALL_BORDER_COLOR);
         }
 
         // Desenha um círculo de escudo se o power-up estiver ativo
         if (shieldTimer > 0) {
             Color shieldEffectColor = Fade(SHIELD_POWERUP_COLOR, 0.5f + 0.3f * sinf(GetTime() * 15));
-            DrawCircle((int)(rect.x + rect.width / 2), (int)(rect.y + rect.height / 2), 35.0f, shieldEffectColor);
+            DrawCircle((int)(r.x + r.width / 2), (int)(r.y + r.height / 2), 35.0f, shieldEffectColor);
         }
     }
 
@@ -198,43 +765,313 @@ public:
     }
 };
 
-// Classe para Paredes 
-class Wall : public Entidade {
-public:
-    Vector2 velocity;
-    // Construtor: Inicializa a posição, dimensões e velocidade da parede.
-    Wall(float x, float y, float w, float h, float vx, float vy) {
-        rect = { x, y, w, h };
-        velocity = { vx, vy };
+// Visão crua dos arrays de paredes usada pelos kernels de atualização.
+struct WallArrays {
+    float *x, *y, *w, *h, *vx, *vy, *prevX, *prevY;
+    size_t n;
+};
+
+// Move todas as paredes em 'delta' segundos, inverte a velocidade das que
+// saíram da tela e, na mesma passada, marca em 'hitMask' (1 bit por parede)
+// as que se sobrepõem ao retângulo do jogador e em 'sweepMask' as cuja caixa
+// percorrida no tick toca 'sweep' (a caixa percorrida pelo jogador), que são
+// as únicas candidatas ao teste contínuo. Retorna o número de colisões.
+// Todas as versões produzem exatamente o mesmo resultado.
+typedef int (*WallKernelFn)(WallArrays a, float delta, Rectangle player, Rectangle sweep, uint32_t* hitMask, uint32_t* sweepMask);
+
+static int WallKernelScalar(WallArrays a, float delta, Rectangle player, Rectangle sweep, uint32_t* hitMask, uint32_t* sweepMask) {
+    int hits = 0;
+    for (size_t i = 0; i < a.n; i++) {
+        float x0 = a.x[i];
+        float y0 = a.y[i];
+        a.prevX[i] = x0;
+        a.prevY[i] = y0;
+        float x = x0 + a.vx[i] * delta;
+        float y = y0 + a.vy[i] * delta;
+        a.x[i] = x;
+        a.y[i] = y;
+        bool outX = x < 0 || x + a.w[i] > SCREEN_WIDTH;
+        bool outY = y < 0 || y + a.h[i] > SCREEN_HEIGHT;
+        a.vx[i] = outX ? -a.vx[i] : a.vx[i];
+        a.vy[i] = outY ? -a.vy[i] : a.vy[i];
+
+        // Mesmo teste de CheckCollisionRecs.
+        bool hit = player.x < x + a.w[i] && player.x + player.width > x &&
+                   player.y < y + a.h[i] && player.y + player.height > y;
+        if (hit) {
+            hitMask[i / 32] |= 1u << (i % 32);
+            hits++;
+        }
+
+        bool near = sweep.x < std::max(x0, x) + a.w[i] && sweep.x + sweep.width > std::min(x0, x) &&
+                    sweep.y < std::max(y0, y) + a.h[i] && sweep.y + sweep.height > std::min(y0, y);
+        if (near) sweepMask[i / 32] |= 1u << (i % 32);
     }
-    // Atualiza a posição da parede e inverte a direção se ela atingir as bordas da tela.
-    void Update(float delta) override {
-        rect.x += velocity.x * delta;
-        rect.y += velocity.y * delta;
+    return hits;
+}
 
-        if (rect.x < 0 || rect.x + rect.width > SCREEN_WIDTH) velocity.x *= -1;
-        if (rect.y < 0 || rect.y + rect.height > SCREEN_HEIGHT) velocity.y *= -1;
+#ifdef LABIRINTO_SIMD_X86
+// Processa 4 paredes por instrução. A inversão de velocidade é feita sem
+// desvios: o bit de sinal é trocado (XOR) apenas nas lanes fora da tela.
+static int WallKernelSSE2(WallArrays a, float delta, Rectangle player, Rectangle sweep, uint32_t* hitMask, uint32_t* sweepMask) {
+    const __m128 dt = _mm_set1_ps(delta);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 screenW = _mm_set1_ps((float)SCREEN_WIDTH);
+    const __m128 screenH = _mm_set1_ps((float)SCREEN_HEIGHT);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 px0 = _mm_set1_ps(player.x);
+    const __m128 px1 = _mm_set1_ps(player.x + player.width);
+    const __m128 py0 = _mm_set1_ps(player.y);
+    const __m128 py1 = _mm_set1_ps(player.y + player.height);
+    const __m128 sx0 = _mm_set1_ps(sweep.x);
+    const __m128 sx1 = _mm_set1_ps(sweep.x + sweep.width);
+    const __m128 sy0 = _mm_set1_ps(sweep.y);
+    const __m128 sy1 = _mm_set1_ps(sweep.y + sweep.height);
+
+    int hits = 0;
+    size_t i = 0;
+    for (; i + 4 <= a.n; i += 4) {
+        __m128 x0 = _mm_loadu_ps(a.x + i);
+        __m128 y0 = _mm_loadu_ps(a.y + i);
+        __m128 w = _mm_loadu_ps(a.w + i);
+        __m128 h = _mm_loadu_ps(a.h + i);
+        __m128 vx = _mm_loadu_ps(a.vx + i);
+        __m128 vy = _mm_loadu_ps(a.vy + i);
+        _mm_storeu_ps(a.prevX + i, x0);
+        _mm_storeu_ps(a.prevY + i, y0);
+
+        __m128 x = _mm_add_ps(x0, _mm_mul_ps(vx, dt));
+        __m128 y = _mm_add_ps(y0, _mm_mul_ps(vy, dt));
+        __m128 x1 = _mm_add_ps(x, w);
+        __m128 y1 = _mm_add_ps(y, h);
+
+        __m128 outX = _mm_or_ps(_mm_cmplt_ps(x, zero), _mm_cmpgt_ps(x1, screenW));
+        __m128 outY = _mm_or_ps(_mm_cmplt_ps(y, zero), _mm_cmpgt_ps(y1, screenH));
+        _mm_storeu_ps(a.vx + i, _mm_xor_ps(vx, _mm_and_ps(outX, sign)));
+        _mm_storeu_ps(a.vy + i, _mm_xor_ps(vy, _mm_and_ps(outY, sign)));
+        _mm_storeu_ps(a.x + i, x);
+        _mm_storeu_ps(a.y + i, y);
+
+        __m128 hit = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(px0, x1), _mm_cmpgt_ps(px1, x)),
+                                _mm_and_ps(_mm_cmplt_ps(py0, y1), _mm_cmpgt_ps(py1, y)));
+        unsigned int bits = (unsigned int)_mm_movemask_ps(hit);
+        if (bits) {
+            hitMask[i / 32] |= bits << (i % 32);
+            hits += __builtin_popcount(bits);
+        }
+
+        __m128 near = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(sx0, _mm_add_ps(_mm_max_ps(x0, x), w)), _mm_cmpgt_ps(sx1, _mm_min_ps(x0, x))),
+                                 _mm_and_ps(_mm_cmplt_ps(sy0, _mm_add_ps(_mm_max_ps(y0, y), h)), _mm_cmpgt_ps(sy1, _mm_min_ps(y0, y))));
+        unsigned int nearBits = (unsigned int)_mm_movemask_ps(near);
+        if (nearBits) sweepMask[i / 32] |= nearBits << (i % 32);
     }
-    // Desenha a parede na tela.
-    void Draw() const override {
-        DrawRectangleRec(rect, WALL_COLOR);
-        DrawRectangleLinesEx(rect, 2, WALL_BORDER_COLOR);
+
+    // Paredes restantes (menos de 4) seguem pela versão escalar.
+    WallArrays tail = { a.x + i, a.y + i, a.w + i, a.h + i, a.vx + i, a.vy + i, a.prevX + i, a.prevY + i, a.n - i };
+    uint32_t tailMask = 0, tailSweep = 0;
+    hits += WallKernelScalar(tail, delta, player, sweep, &tailMask, &tailSweep);
+    if (tailMask) hitMask[i / 32] |= tailMask << (i % 32);
+    if (tailSweep) sweepMask[i / 32] |= tailSweep << (i % 32);
+    return hits;
+}
+
+// Mesma lógica da versão SSE2, com 8 paredes por instrução.
+__attribute__((target("avx2")))
+static int WallKernelAVX2(WallArrays a, float delta, Rectangle player, Rectangle sweep, uint32_t* hitMask, uint32_t* sweepMask) {
+    const __m256 dt = _mm256_set1_ps(delta);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 screenW = _mm256_set1_ps((float)SCREEN_WIDTH);
+    const __m256 screenH = _mm256_set1_ps((float)SCREEN_HEIGHT);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 px0 = _mm256_set1_ps(player.x);
+    const __m256 px1 = _mm256_set1_ps(player.x + player.width);
+    const __m256 py0 = _mm256_set1_ps(player.y);
+    const __m256 py1 = _mm256_set1_ps(player.y + player.height);
+    const __m256 sx0 = _mm256_set1_ps(sweep.x);
+    const __m256 sx1 = _mm256_set1_ps(sweep.x + sweep.width);
+    const __m256 sy0 = _mm256_set1_ps(sweep.y);
+    const __m256 sy1 = _mm256_set1_ps(sweep.y + sweep.height);
+
+    int hits = 0;
+    size_t i = 0;
+    for (; i + 8 <= a.n; i += 8) {
+        __m256 x0 = _mm256_loadu_ps(a.x + i);
+        __m256 y0 = _mm256_loadu_ps(a.y + i);
+        __m256 w = _mm256_loadu_ps(a.w + i);
+        __m256 h = _mm256_loadu_ps(a.h + i);
+        __m256 vx = _mm256_loadu_ps(a.vx + i);
+        __m256 vy = _mm256_loadu_ps(a.vy + i);
+        _mm256_storeu_ps(a.prevX + i, x0);
+        _mm256_storeu_ps(a.prevY + i, y0);
+
+        __m256 x = _mm256_add_ps(x0, _mm256_mul_ps(vx, dt));
+        __m256 y = _mm256_add_ps(y0, _mm256_mul_ps(vy, dt));
+        __m256 x1 = _mm256_add_ps(x, w);
+        __m256 y1 = _mm256_add_ps(y, h);
+
+        __m256 outX = _mm256_or_ps(_mm256_cmp_ps(x, zero, _CMP_LT_OQ), _mm256_cmp_ps(x1, screenW, _CMP_GT_OQ));
+        __m256 outY = _mm256_or_ps(_mm256_cmp_ps(y, zero, _CMP_LT_OQ), _mm256_cmp_ps(y1, screenH, _CMP_GT_OQ));
+        _mm256_storeu_ps(a.vx + i, _mm256_xor_ps(vx, _mm256_and_ps(outX, sign)));
+        _mm256_storeu_ps(a.vy + i, _mm256_xor_ps(vy, _mm256_and_ps(outY, sign)));
+        _mm256_storeu_ps(a.x + i, x);
+        _mm256_storeu_ps(a.y + i, y);
+
+        __m256 hit = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(px0, x1, _CMP_LT_OQ), _mm256_cmp_ps(px1, x, _CMP_GT_OQ)),
+                                   _mm256_and_ps(_mm256_cmp_ps(py0, y1, _CMP_LT_OQ), _mm256_cmp_ps(py1, y, _CMP_GT_OQ)));
+        unsigned int bits = (unsigned int)_mm256_movemask_ps(hit);
+        if (bits) {
+            hitMask[i / 32] |= bits << (i % 32);
+            hits += __builtin_popcount(bits);
+        }
+
+        __m256 near = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(sx0, _mm256_add_ps(_mm256_max_ps(x0, x), w), _CMP_LT_OQ), _mm256_cmp_ps(sx1, _mm256_min_ps(x0, x), _CMP_GT_OQ)),
+                                    _mm256_and_ps(_mm256_cmp_ps(sy0, _mm256_add_ps(_mm256_max_ps(y0, y), h), _CMP_LT_OQ), _mm256_cmp_ps(sy1, _mm256_min_ps(y0, y), _CMP_GT_OQ)));
+        unsigned int nearBits = (unsigned int)_mm256_movemask_ps(near);
+        if (nearBits) sweepMask[i / 32] |= nearBits << (i % 32);
     }
-};
 
-// Classe para Paredes Especiais
-class ParedeEspecial : public Wall {
+    WallArrays tail = { a.x + i, a.y + i, a.w + i, a.h + i, a.vx + i, a.vy + i, a.prevX + i, a.prevY + i, a.n - i };
+    uint32_t tailMask = 0, tailSweep = 0;
+    hits += WallKernelScalar(tail, delta, player, sweep, &tailMask, &tailSweep);
+    if (tailMask) hitMask[i / 32] |= tailMask << (i % 32);
+    if (tailSweep) sweepMask[i / 32] |= tailSweep << (i % 32);
+    return hits;
+}
+#endif
+
+// Escolhe o melhor kernel disponível na CPU em que o jogo está rodando.
+static WallKernelFn SelectWallKernel(const char** name) {
+#ifdef LABIRINTO_SIMD_X86
+    if (__builtin_cpu_supports("avx2")) { *name = "avx2"; return WallKernelAVX2; }
+    *name = "sse2";
+    return WallKernelSSE2;
+#else
+    *name = "escalar";
+    return WallKernelScalar;
+#endif
+}
+
+static const char* wallKernelName = "escalar";
+static const WallKernelFn wallKernel = SelectWallKernel(&wallKernelName);
+
+// Tipos de parede. A parede especial só difere no visual, então é apenas uma
+// marca no armazenamento em vez de uma subclasse.
+enum class WallKind : unsigned char { NORMAL, ESPECIAL };
+
+// Armazenamento das paredes em estrutura-de-arrays (SoA): cada atributo fica
+// em um array contíguo, e todas as paredes são movidas em uma única passada
+// sem alocação por parede nem chamada virtual.
+class WallStore {
 public:
-    // Construtor: Chama o construtor da classe base Wall.
-    ParedeEspecial(float x, float y, float w, float h, float vx, float vy) : Wall(x, y, w, h, vx, vy) {}
-    // Desenha a parede com um efeito de pulsação de opacidade e design diferente das paredes normais
-    void Draw() const override {
+    std::vector<float> x, y, w, h;
+    std::vector<float> vx, vy;
+    std::vector<float> prevX, prevY; // Posição no tick anterior, para interpolação no desenho.
+    std::vector<WallKind> kind;
+    std::vector<uint32_t> hitMask;   // 1 bit por parede: colidiu com o jogador no último tick.
+    std::vector<uint32_t> sweepMask; // 1 bit por parede: candidata ao teste contínuo (ver SweepPlayer).
+
+    size_t Size() const { return x.size(); }
+
+    // Redimensiona todos os arrays para 'n' paredes (usado pelo carregador de níveis).
+    void Resize(size_t n) {
+        x.resize(n); y.resize(n); w.resize(n); h.resize(n);
+        vx.resize(n); vy.resize(n);
+        prevX.resize(n); prevY.resize(n);
+        kind.resize(n);
+        hitMask.resize((n + 31) / 32);
+        sweepMask.resize((n + 31) / 32);
+    }
+
+    void Clear() {
+        x.clear(); y.clear(); w.clear(); h.clear();
+        vx.clear(); vy.clear();
+        prevX.clear(); prevY.clear();
+        kind.clear();
+        hitMask.clear();
+        sweepMask.clear();
+    }
+
+    // Adiciona uma parede com posição, dimensões, velocidade e tipo.
+    void Add(float px, float py, float pw, float ph, float pvx, float pvy, WallKind k = WallKind::NORMAL) {
+        x.push_back(px); y.push_back(py); w.push_back(pw); h.push_back(ph);
+        vx.push_back(pvx); vy.push_back(pvy);
+        prevX.push_back(px); prevY.push_back(py);
+        kind.push_back(k);
+        hitMask.resize((Size() + 31) / 32);
+        sweepMask.resize((Size() + 31) / 32);
+    }
+
+    Rectangle Rect(size_t i) const { return { x[i], y[i], w[i], h[i] }; }
+    Rectangle PrevRect(size_t i) const { return { prevX[i], prevY[i], w[i], h[i] }; }
+
+    // Move todas as paredes, inverte a direção das que atingiram as bordas da
+    // tela e testa cada uma contra o jogador (que foi de 'playerPrev' para
+    // 'player' neste tick), tudo em uma única passada. Retorna quantas paredes
+    // colidiram; quais foram fica em 'hitMask', e as candidatas ao teste
+    // contínuo em 'sweepMask'. Com 'jobs', blocos de paredes rodam em
+    // paralelo; cada bloco começa em um múltiplo de 32 e só escreve nas
+    // próprias palavras das máscaras.
+    int UpdateAndCollide(float delta, Rectangle playerPrev, Rectangle player, JobSystem* jobs = nullptr) {
+        // Caixa que envolve todo o trajeto do jogador no tick.
+        Rectangle sweep;
+        sweep.x = std::min(playerPrev.x, player.x);
+        sweep.y = std::min(playerPrev.y, player.y);
+        sweep.width = std::max(playerPrev.x, player.x) + player.width - sweep.x;
+        sweep.height = std::max(playerPrev.y, player.y) + player.height - sweep.y;
+
+        std::fill(hitMask.begin(), hitMask.end(), 0u);
+        std::fill(sweepMask.begin(), sweepMask.end(), 0u);
+        std::atomic<int> hits{ 0 };
+        ParallelFor(jobs, Size(), JOB_GRAIN, [&](size_t begin, size_t end) {
+            WallArrays a = { x.data() + begin, y.data() + begin, w.data() + begin, h.data() + begin,
+                             vx.data() + begin, vy.data() + begin, prevX.data() + begin, prevY.data() + begin, end - begin };
+            hits.fetch_add(wallKernel(a, delta, player, sweep, hitMask.data() + begin / 32, sweepMask.data() + begin / 32),
+                           std::memory_order_relaxed);
+        });
+        return hits.load(std::memory_order_relaxed);
+    }
+
+    bool Hit(size_t i) const { return (hitMask[i / 32] >> (i % 32)) & 1u; }
+
+    // Procura a primeira parede que o jogador atravessou durante o último tick
+    // (movendo-se de 'playerPrev' para 'playerCur', os mesmos retângulos
+    // passados a UpdateAndCollide), mesmo que no fim do tick já não haja
+    // sobreposição. Só as paredes marcadas em 'sweepMask' pelo kernel passam
+    // pelo teste contínuo; as palavras zeradas pulam 32 paredes de uma vez.
+    // Retorna o índice da parede de menor instante de impacto, ou -1, e grava
+    // esse instante em 'toi'.
+    int SweepPlayer(Rectangle playerPrev, Rectangle playerCur, float* toi) const {
+        int best = -1;
+        float bestToi = 1.0f;
+        for (size_t word = 0; word < sweepMask.size(); word++) {
+            for (uint32_t bits = sweepMask[word]; bits; bits &= bits - 1) {
+                size_t i = word * 32 + (size_t)__builtin_ctz(bits);
+                float t;
+                if (SweptAABB(playerPrev, playerCur, PrevRect(i), Rect(i), &t) && (best < 0 || t < bestToi)) {
+                    best = (int)i;
+                    bestToi = t;
+                }
+            }
+        }
+        if (best >= 0) *toi = bestToi;
+        return best;
+    }
+
+    // Desenha a parede 'i' no retângulo informado (posição interpolada entre ticks).
+    void DrawAt(size_t i, Rectangle r) const {
+        if (kind[i] == WallKind::NORMAL) {
+            DrawRectangleRec(r, WALL_COLOR);
+            DrawRectangleLinesEx(r, 2, WALL_BORDER_COLOR);
+            return;
+        }
+
+        // Parede especial: efeito de pulsação de opacidade e design diferente das paredes normais.
         float alpha = (sinf(GetTime() * 8.0f) + 1.0f) / 2.0f;
-        DrawRectangleRec(rect, Fade(SPECIAL_WALL_COLOR, 0.4f + alpha * 0.6f));
-        DrawRectangleLinesEx(rect, 4, Fade(SPECIAL_WALL_BORDER_COLOR, alpha * 0.9f));
+        DrawRectangleRec(r, Fade(SPECIAL_WALL_COLOR, 0.4f + alpha * 0.6f));
+        DrawRectangleLinesEx(r, 4, Fade(SPECIAL_WALL_BORDER_COLOR, alpha * 0.9f));
 
-        for(int i = 0; i <= rect.width; i += 15) DrawLine((int)rect.x + i, (int)rect.y, (int)rect.x + i, (int)(rect.y + rect.height), Fade(UI_HIGHLIGHT_COLOR, ( (sinf(GetTime() * 12.0f) + 1.0f) / 2.0f) * 0.3f));
-        for(int i = 0; i <= rect.height; i += 15) DrawLine((int)rect.x, (int)rect.y + i, (int)(rect.x + rect.width), (int)rect.y + i, Fade(UI_HIGHLIGHT_COLOR, ( (sinf(GetTime() * 12.0f) + 1.0f) / 2.0f) * 0.3f));
+        for(int j = 0; j <= r.width; j += 15) DrawLine((int)r.x + j, (int)r.y, (int)r.x + j, (int)(r.y + r.height), Fade(UI_HIGHLIGHT_COLOR, ( (sinf(GetTime() * 12.0f) + 1.0f) / 2.0f) * 0.3f));
+        for(int j = 0; j <= r.height; j += 15) DrawLine((int)r.x, (int)r.y + j, (int)(r.x + r.width), (int)r.y + j, Fade(UI_HIGHLIGHT_COLOR, ( (sinf(GetTime() * 12.0f) + 1.0f) / 2.0f) * 0.3f));
     }
 };
 
@@ -300,162 +1137,2314 @@ public:
 };
 
 // =============================================================================
-//                      CLASSES DE ITENS COLETÁVEIS E POWER-UPS
+//                      ENTIDADES E COMPONENTES (MOEDAS E POWER-UPS)
+// =============================================================================
+
+// Uma entidade é só um índice; o que ela "é" depende dos componentes que tem.
+// Moedas têm transformação, coletável e pulso; power-ups têm transformação,
+// coletável e reaparecimento. Os índices são densos dentro de um nível (o mundo
+// é limpo a cada nível), então servem direto como ids das grades espaciais.
+using EntityId = uint32_t;
+
+enum class CollectibleKind : uint8_t { COIN, POWERUP };
+
+// Posição e tamanho da entidade.
+struct TransformComponent {
+    Rectangle rect;
+};
+
+// Algo que o jogador pode pegar. 'powerUp' só vale para CollectibleKind::POWERUP.
+struct CollectibleComponent {
+    CollectibleKind kind;
+    PowerUpType powerUp;
+    bool active;
+};
+
+// Fase da animação de pulsação (sorteada na criação para as moedas não
+// pulsarem em sincronia).
+struct PulseComponent {
+    float phase;
+};
+
+// Tempo até a entidade (re)aparecer em uma posição aleatória.
+struct SpawnComponent {
+    float timer;
+};
+
+// Armazenamento denso de um componente (sparse set): os valores ficam
+// contíguos em 'dense', na ordem em que foram adicionados, e 'sparse' leva do
+// id da entidade à posição em 'dense'. Os sistemas percorrem 'dense' direto,
+// sem tocar nos componentes que não usam.
+template <typename T>
+class ComponentPool {
+public:
+    static constexpr int NONE = -1;
+
+    std::vector<T> dense;
+    std::vector<EntityId> owners; // owners[i] é a entidade dona de dense[i].
+    std::vector<int> sparse;
+
+    size_t Size() const { return dense.size(); }
+
+    T& Add(EntityId e, const T& value) {
+        if (e >= sparse.size()) sparse.resize((size_t)e + 1, NONE);
+        sparse[e] = (int)dense.size();
+        dense.push_back(value);
+        owners.push_back(e);
+        return dense.back();
+    }
+
+    bool Has(EntityId e) const { return e < sparse.size() && sparse[e] != NONE; }
+    T& Get(EntityId e) { return dense[(size_t)sparse[e]]; }
+    const T& Get(EntityId e) const { return dense[(size_t)sparse[e]]; }
+
+    void Reserve(size_t n) {
+        dense.reserve(n);
+        owners.reserve(n);
+    }
+
+    void Clear() {
+        dense.clear();
+        owners.clear();
+        sparse.clear();
+    }
+};
+
+// Todas as entidades coletáveis do nível e seus componentes.
+class EntityWorld {
+public:
+    ComponentPool<TransformComponent> transforms;
+    ComponentPool<CollectibleComponent> collectibles;
+    ComponentPool<PulseComponent> pulses;
+    ComponentPool<SpawnComponent> spawners;
+
+    EntityId Create() { return count++; }
+    EntityId Count() const { return count; }
+
+    void Reserve(size_t n) {
+        transforms.Reserve(n);
+        collectibles.Reserve(n);
+    }
+
+    void Clear() {
+        transforms.Clear();
+        collectibles.Clear();
+        pulses.Clear();
+        spawners.Clear();
+        count = 0;
+    }
+
+    // Cria uma moeda ativa em (x, y).
+    EntityId CreateCoin(float x, float y, Random& rng) {
+        EntityId e = Create();
+        transforms.Add(e, { { x, y, 15, 15 } });
+        collectibles.Add(e, { CollectibleKind::COIN, PowerUpType::LIFE, true });
+        pulses.Add(e, { (float)rng.Int(0, 100) });
+        return e;
+    }
+
+    // Cria um power-up inativo, que surge quando o timer de reaparecimento zerar.
+    EntityId CreatePowerUp(PowerUpType type, Random& rng) {
+        EntityId e = Create();
+        transforms.Add(e, { { 0, 0, 25, 25 } });
+        collectibles.Add(e, { CollectibleKind::POWERUP, type, false });
+        spawners.Add(e, { (float)rng.Int(8, 15) });
+        return e;
+    }
+
+private:
+    EntityId count = 0;
+};
+
+// Sistema de reaparecimento, em duas etapas. TickSpawnTimers corre os timers
+// das entidades inativas no intervalo [begin, end) do pool e marca em 'due' as
+// que devem surgir; não sorteia nada, então blocos diferentes podem rodar em
+// paralelo. SpawnDue depois as ativa em posições aleatórias, sempre na ordem
+// do pool, para a sequência do gerador não depender das threads.
+static void TickSpawnTimers(EntityWorld& world, float delta, size_t begin, size_t end, uint8_t* due) {
+    auto& spawners = world.spawners;
+    for (size_t i = begin; i < end; i++) {
+        due[i] = 0;
+        if (world.collectibles.Get(spawners.owners[i]).active) continue;
+        SpawnComponent& s = spawners.dense[i];
+        s.timer -= delta;
+        due[i] = s.timer <= 0;
+    }
+}
+
+// Chama 'onSpawn(e)' para cada entidade que surgir.
+template <typename Fn>
+static void SpawnDue(EntityWorld& world, const uint8_t* due, Random& rng, Fn&& onSpawn) {
+    auto& spawners = world.spawners;
+    for (size_t i = 0; i < spawners.Size(); i++) {
+        if (!due[i]) continue;
+        EntityId e = spawners.owners[i];
+        SpawnComponent& s = spawners.dense[i];
+        world.collectibles.Get(e).active = true;
+        // Define uma posição aleatória na tela, com margem das bordas.
+        Rectangle& rect = world.transforms.Get(e).rect;
+        rect.x = (float)rng.Int(100, SCREEN_WIDTH - 100);
+        rect.y = (float)rng.Int(100, SCREEN_HEIGHT - 100);
+        s.timer = (float)rng.Int(15, 25);
+        onSpawn(e);
+    }
+}
+
+// Tenta coletar a entidade 'e' com o jogador. Power-ups aplicam o efeito
+// correspondente ao tipo; moedas só ficam inativas (a pontuação é da Simulation).
+static bool TryCollect(EntityWorld& world, EntityId e, Player& player) {
+    CollectibleComponent& c = world.collectibles.Get(e);
+    if (!c.active || !CheckCollisionRecs(player.rect, world.transforms.Get(e).rect)) return false;
+    c.active = false;
+    if (c.kind == CollectibleKind::POWERUP) {
+        if (c.powerUp == PowerUpType::LIFE && player.lives < 3) player.lives++;
+        if (c.powerUp == PowerUpType::SHIELD) player.shieldTimer = 5.0f;
+        if (c.powerUp == PowerUpType::SPEED) {
+            player.speedBoostTimer = 4.0f;
+            player.currentSpeed = player.baseSpeed * 1.5f;
+        }
+    }
+    return true;
+}
+
+// Desenha as moedas ativas, com um efeito de pulsação de tamanho.
+static void DrawCoins(const EntityWorld& world) {
+    const auto& pulses = world.pulses;
+    for (size_t i = 0; i < pulses.Size(); i++) {
+        EntityId e = pulses.owners[i];
+        if (!world.collectibles.Get(e).active) continue;
+        const Rectangle& rect = world.transforms.Get(e).rect;
+        float pulse = pulses.dense[i].phase;
+        float sizeFactor = 1.0f + 0.15f * sinf(GetTime() * 5.0f + pulse);
+        float glowAlpha = 0.4f + 0.4f * sinf(GetTime()*10.0f + pulse);
+        int cx = (int)(rect.x + rect.width / 2);
+        int cy = (int)(rect.y + rect.height / 2);
+
+        // Brilho externo da moeda.
+        DrawCircle(cx, cy, (rect.width / 2) * sizeFactor * 1.8f, Fade(COIN_GLOW_COLOR, glowAlpha));
+
+        DrawCircle(cx, cy, (rect.width / 2) * sizeFactor, COIN_COLOR);
+
+        // Efeito de orbe/energia no centro da moeda.
+        DrawCircle(cx, cy, (rect.width / 2) * sizeFactor * 0.4f, Fade(UI_HIGHLIGHT_COLOR, glowAlpha * 0.8f));
+    }
+}
+
+// Desenha os power-ups ativos de acordo com o seu tipo.
+static void DrawPowerUps(const EntityWorld& world) {
+    const auto& spawners = world.spawners;
+    for (size_t i = 0; i < spawners.Size(); i++) {
+        EntityId e = spawners.owners[i];
+        const CollectibleComponent& c = world.collectibles.Get(e);
+        if (!c.active) continue;
+        const Rectangle& rect = world.transforms.Get(e).rect;
+
+        Color color;
+        const char* t;
+        if (c.powerUp == PowerUpType::LIFE) { color = LIFE_POWERUP_COLOR; t = "L"; }
+        else if (c.powerUp == PowerUpType::SHIELD) { color = SHIELD_POWERUP_COLOR; t = "S"; }
+        else { color = SPEED_POWERUP_COLOR; t = "V"; }
+
+        float pulseAlpha = 0.2f + 0.2f * sinf(GetTime() * 12.0f);
+
+        // Brilho de fundo pulsante.
+        DrawCircle((int)(rect.x + rect.width / 2), (int)(rect.y + rect.height / 2), rect.width * 1.5f, Fade(color, pulseAlpha));
+
+        // Desenha o fundo e a borda do power-up.
+        DrawRectangleRec(rect, color);
+        DrawRectangleLinesEx(rect, 2, Fade(UI_HIGHLIGHT_COLOR, 0.7f + 0.3f * sinf(GetTime() * 10.0f)));
+
+        // Desenha o ícone/texto dentro do power-up.
+        Vector2 textSize = MeasureTextEx(GetFontDefault(), t, 20, 1);
+        DrawText(t, (int)(rect.x + (rect.width - textSize.x) / 2), (int)(rect.y + (rect.height - textSize.y) / 2), 20, UI_HIGHLIGHT_COLOR);
+    }
+}
+
+// =============================================================================
+//                     GRADE ESPACIAL (BROAD-PHASE DE COLISÃO)
+// =============================================================================
+
+// Grade uniforme que cobre a tela e guarda, em cada célula, os índices das
+// entidades cujo retângulo a toca. Consultas por retângulo visitam só as
+// células envolvidas, em vez de percorrer todas as entidades do nível.
+// Guarda moedas e power-ups (as paredes não entram; ver Simulation). Com
+// células de 40 px, maiores que moedas (15 px) e power-ups (25 px), cada um
+// toca no máximo 4 células.
+class SpatialHash {
+public:
+    static constexpr float CELL_SIZE = 40.0f;
+
+    SpatialHash() {
+        cols = (int)ceilf(SCREEN_WIDTH / CELL_SIZE);
+        rows = (int)ceilf(SCREEN_HEIGHT / CELL_SIZE);
+        cells.resize((size_t)(cols * rows));
+    }
+
+    // Remove tudo e prepara a grade para 'count' entidades (índices 0..count-1).
+    void Reset(int count) {
+        for (auto& cell : cells) cell.clear();
+        ranges.assign((size_t)count, CellRange{});
+        stamps.assign((size_t)count, 0);
+        queryStamp = 0;
+    }
+
+    // Insere a entidade 'id' nas células cobertas por 'r'.
+    void Insert(int id, Rectangle r) {
+        CellRange range = RangeOf(r);
+        ranges[id] = range;
+        ForEachCell(range, [&](std::vector<int>& cell) { cell.push_back(id); });
+    }
+
+    // Remove a entidade 'id' de todas as células em que estiver.
+    void Remove(int id) {
+        if (!ranges[id].valid) return;
+        ForEachCell(ranges[id], [&](std::vector<int>& cell) {
+            auto it = std::find(cell.begin(), cell.end(), id);
+            if (it != cell.end()) {
+                *it = cell.back();
+                cell.pop_back();
+            }
+        });
+        ranges[id].valid = false;
+    }
+
+    // Atualiza a entidade 'id' após ela se mover. Só mexe nas células quando o
+    // conjunto de células cobertas muda, o que é raro para movimentos por tick.
+    void Move(int id, Rectangle r) {
+        CellRange range = RangeOf(r);
+        if (ranges[id].valid && range == ranges[id]) return;
+        Remove(id);
+        ranges[id] = range;
+        ForEachCell(range, [&](std::vector<int>& cell) { cell.push_back(id); });
+    }
+
+    // Chama 'fn(id)' uma única vez para cada entidade que pode tocar 'r'.
+    // É um teste grosseiro: quem chama ainda faz o CheckCollisionRecs exato.
+    // 'fn' não pode chamar Insert/Remove/Move nesta grade (as células estão
+    // sendo percorridas); quem precisar disso guarda os ids e altera depois.
+    template <typename Fn>
+    void Query(Rectangle r, Fn&& fn) {
+        queryStamp++;
+        ForEachCell(RangeOf(r), [&](std::vector<int>& cell) {
+            for (int id : cell) {
+                if (stamps[id] == queryStamp) continue;
+                stamps[id] = queryStamp;
+                fn(id);
+            }
+        });
+    }
+
+private:
+    // Intervalo de células [x0..x1] x [y0..y1] coberto por um retângulo.
+    struct CellRange {
+        int x0 = 0, y0 = 0, x1 = -1, y1 = -1;
+        bool valid = false;
+        bool operator==(const CellRange& o) const { return x0 == o.x0 && y0 == o.y0 && x1 == o.x1 && y1 == o.y1; }
+    };
+
+    int cols, rows;
+    std::vector<std::vector<int>> cells;
+    std::vector<CellRange> ranges;
+    std::vector<unsigned int> stamps;
+    unsigned int queryStamp = 0;
+
+    CellRange RangeOf(Rectangle r) const {
+        // Truncar em vez de floorf é seguro: coordenadas negativas caem na
+        // célula 0 de qualquer forma por causa do clamp.
+        const float inv = 1.0f / CELL_SIZE;
+        CellRange range;
+        range.x0 = std::clamp((int)(r.x * inv), 0, cols - 1);
+        range.y0 = std::clamp((int)(r.y * inv), 0, rows - 1);
+        range.x1 = std::clamp((int)((r.x + r.width) * inv), 0, cols - 1);
+        range.y1 = std::clamp((int)((r.y + r.height) * inv), 0, rows - 1);
+        range.valid = true;
+        return range;
+    }
+
+    template <typename Fn>
+    void ForEachCell(const CellRange& range, Fn&& fn) {
+        for (int y = range.y0; y <= range.y1; y++) {
+            for (int x = range.x0; x <= range.x1; x++) fn(cells[(size_t)(y * cols + x)]);
+        }
+    }
+};
+
+// =============================================================================
+//                        ARQUIVOS MAPEADOS EM MEMÓRIA
+// =============================================================================
+
+// Arquivo somente-leitura mapeado em memória: o conteúdo é acessado direto
+// pelas páginas do sistema operacional, sem cópia para um buffer intermediário.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const char* path) { Open(path); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { Close(); }
+
+    bool IsOpen() const { return data != nullptr; }
+    const unsigned char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+    // Mapeia o arquivo inteiro. Retorna false se não existir, estiver vazio
+    // ou não puder ser mapeado.
+    bool Open(const char* path) {
+        Close();
+#if defined(_WIN32)
+        const unsigned long GENERIC_READ_ = 0x80000000UL, FILE_SHARE_READ_ = 1, OPEN_EXISTING_ = 3;
+        const unsigned long FILE_ATTRIBUTE_NORMAL_ = 0x80, PAGE_READONLY_ = 2, FILE_MAP_READ_ = 4;
+        void* const INVALID_HANDLE = (void*)(intptr_t)-1;
+
+        file = CreateFileA(path, GENERIC_READ_, FILE_SHARE_READ_, nullptr, OPEN_EXISTING_, FILE_ATTRIBUTE_NORMAL_, nullptr);
+        if (file == INVALID_HANDLE) { file = nullptr; return false; }
+        long long fileSize = 0;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize <= 0) { Close(); return false; }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY_, 0, 0, nullptr);
+        if (!mapping) { Close(); return false; }
+        data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ_, 0, 0, 0);
+        if (!data) { Close(); return false; }
+        size = (size_t)fileSize;
+#else
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) { close(fd); return false; }
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) return false;
+        data = (const unsigned char*)p;
+        size = (size_t)st.st_size;
+#endif
+        return true;
+    }
+
+    void Close() {
+#if defined(_WIN32)
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file) CloseHandle(file);
+        mapping = nullptr;
+        file = nullptr;
+#else
+        if (data) munmap((void*)data, size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+private:
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+#if defined(_WIN32)
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+};
+
+// =============================================================================
+//                              ARQUIVOS DE NÍVEL
+// =============================================================================
+
+// Os níveis ficam em "levels/levelN.lvl" (binário, carregado por mmap) e
+// "levels/levelN.txt" (texto, usado para autoria e como alternativa quando o
+// binário não existe), com "levels/" ao lado do executável. O binário é gerado com "--build-level entrada.txt saida.lvl".
+//
+// Layout do binário (little-endian, tudo alinhado em 4 bytes):
+//   LevelFileHeader
+//   paredes:   x[n] y[n] w[n] h[n] vx[n] vy[n] (float), kind[n] (uint8, com padding até 4)
+//   moedas:    x[n] y[n] (float)
+//   power-ups: type[n] (uint8, com padding até 4)
+// As paredes já estão no mesmo formato de arrays do WallStore, então a carga é
+// apenas uma cópia de bloco por atributo.
+struct LevelFileHeader {
+    char magic[4];          // "LDSN"
+    uint32_t version;
+    uint32_t wallCount;
+    uint32_t coinCount;
+    uint32_t powerupCount;
+    float goalX, goalY;
+    uint32_t reserved;
+};
+
+static const char LEVEL_MAGIC[4] = { 'L', 'D', 'S', 'N' };
+static const uint32_t LEVEL_VERSION = 1;
+
+// Conteúdo de um nível, antes de virar entidades da simulação.
+struct LevelData {
+    WallStore walls;
+    std::vector<Vector2> coins;
+    std::vector<PowerUpType> powerups;
+    Vector2 goal = { (float)SCREEN_WIDTH - 80, (float)SCREEN_HEIGHT / 2.0f - 20 };
+};
+
+static inline size_t Align4(size_t n) { return (n + 3) & ~(size_t)3; }
+
+// Pasta dos níveis, resolvida a partir do executável e não da pasta atual,
+// para o jogo achar os níveis qualquer que seja o diretório de onde foi
+// aberto. Calculada uma única vez porque GetApplicationDirectory() também
+// devolve um buffer estático.
+static const std::string& LevelsDir() {
+    static const std::string dir = std::string(GetApplicationDirectory()) + "levels/";
+    return dir;
+}
+
+static std::string LevelPath(int level, const char* extension) {
+    // Sem TextFormat: ele usa um buffer estático compartilhado e esta função
+    // também roda na thread do LevelPrefetcher.
+    char name[32];
+    snprintf(name, sizeof(name), "level%d.%s", level, extension);
+    return LevelsDir() + name;
+}
+
+// Lê a forma de texto de um nível. Linhas vazias e iniciadas por '#' são ignoradas.
+static bool ParseLevelText(const char* path, LevelData& out) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    out = LevelData();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        std::istringstream ss(line);
+        std::string cmd;
+        if (!(ss >> cmd) || cmd[0] == '#') continue;
+
+        bool ok = true;
+        if (cmd == "wall" || cmd == "special") {
+            float x, y, w, h, vx, vy;
+            ok = (bool)(ss >> x >> y >> w >> h >> vx >> vy);
+            if (ok) out.walls.Add(x, y, w, h, vx, vy, cmd == "wall" ? WallKind::NORMAL : WallKind::ESPECIAL);
+        } else if (cmd == "coin") {
+            Vector2 c;
+            ok = (bool)(ss >> c.x >> c.y);
+            if (ok) out.coins.push_back(c);
+        } else if (cmd == "goal") {
+            ok = (bool)(ss >> out.goal.x >> out.goal.y);
+        } else if (cmd == "powerup") {
+            std::string type;
+            ss >> type;
+            if (type == "LIFE") out.powerups.push_back(PowerUpType::LIFE);
+            else if (type == "SHIELD") out.powerups.push_back(PowerUpType::SHIELD);
+            else if (type == "SPEED") out.powerups.push_back(PowerUpType::SPEED);
+            else ok = false;
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            TraceLog(LOG_WARNING, "LEVEL: %s:%d: linha inválida: %s", path, lineNumber, line.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// Grava um nível no formato binário.
+static bool WriteLevelBinary(const LevelData& level, const char* path) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+
+    const WallStore& w = level.walls;
+    LevelFileHeader header = {};
+    memcpy(header.magic, LEVEL_MAGIC, sizeof(header.magic));
+    header.version = LEVEL_VERSION;
+    header.wallCount = (uint32_t)w.Size();
+    header.coinCount = (uint32_t)level.coins.size();
+    header.powerupCount = (uint32_t)level.powerups.size();
+    header.goalX = level.goal.x;
+    header.goalY = level.goal.y;
+    out.write((const char*)&header, sizeof(header));
+
+    const char padding[4] = { 0, 0, 0, 0 };
+    for (const std::vector<float>* arr : { &w.x, &w.y, &w.w, &w.h, &w.vx, &w.vy }) {
+        out.write((const char*)arr->data(), (std::streamsize)(arr->size() * sizeof(float)));
+    }
+    out.write((const char*)w.kind.data(), (std::streamsize)w.kind.size());
+    out.write(padding, (std::streamsize)(Align4(w.kind.size()) - w.kind.size()));
+
+    for (const Vector2& c : level.coins) out.write((const char*)&c.x, sizeof(float));
+    for (const Vector2& c : level.coins) out.write((const char*)&c.y, sizeof(float));
+
+    for (PowerUpType t : level.powerups) {
+        unsigned char b = (unsigned char)t;
+        out.write((const char*)&b, 1);
+    }
+    out.write(padding, (std::streamsize)(Align4(level.powerups.size()) - level.powerups.size()));
+    return (bool)out;
+}
+
+// Carrega um nível binário mapeando o arquivo e copiando cada array direto
+// para o destino. Rejeita arquivos com cabeçalho, versão ou tamanho inválidos.
+static bool LoadLevelBinary(const char* path, LevelData& out) {
+    MappedFile file(path);
+    if (!file.IsOpen() || file.Size() < sizeof(LevelFileHeader)) return false;
+
+    LevelFileHeader header;
+    memcpy(&header, file.Data(), sizeof(header));
+    if (memcmp(header.magic, LEVEL_MAGIC, sizeof(header.magic)) != 0 || header.version != LEVEL_VERSION) {
+        TraceLog(LOG_WARNING, "LEVEL: %s: cabeçalho ou versão inválidos", path);
+        return false;
+    }
+
+    size_t walls = header.wallCount, coins = header.coinCount, powerups = header.powerupCount;
+    size_t expected = sizeof(header) + walls * 6 * sizeof(float) + Align4(walls)
+                    + coins * 2 * sizeof(float) + Align4(powerups);
+    if (file.Size() != expected) {
+        TraceLog(LOG_WARNING, "LEVEL: %s: tamanho inesperado", path);
+        return false;
+    }
+
+    const unsigned char* p = file.Data() + sizeof(header);
+    auto readFloats = [&](float* dst, size_t n) {
+        memcpy(dst, p, n * sizeof(float));
+        p += n * sizeof(float);
+    };
+
+    out = LevelData();
+    WallStore& w = out.walls;
+    w.Resize(walls);
+    readFloats(w.x.data(), walls);
+    readFloats(w.y.data(), walls);
+    readFloats(w.w.data(), walls);
+    readFloats(w.h.data(), walls);
+    readFloats(w.vx.data(), walls);
+    readFloats(w.vy.data(), walls);
+    for (size_t i = 0; i < walls; i++) {
+        if (p[i] > (unsigned char)WallKind::ESPECIAL) return false;
+        w.kind[i] = (WallKind)p[i];
+    }
+    p += Align4(walls);
+    w.prevX = w.x;
+    w.prevY = w.y;
+
+    out.coins.resize(coins);
+    for (size_t i = 0; i < coins; i++) memcpy(&out.coins[i].x, p + i * sizeof(float), sizeof(float));
+    p += coins * sizeof(float);
+    for (size_t i = 0; i < coins; i++) memcpy(&out.coins[i].y, p + i * sizeof(float), sizeof(float));
+    p += coins * sizeof(float);
+
+    out.powerups.resize(powerups);
+    for (size_t i = 0; i < powerups; i++) {
+        if (p[i] > (unsigned char)PowerUpType::SPEED) return false;
+        out.powerups[i] = (PowerUpType)p[i];
+    }
+
+    out.goal = { header.goalX, header.goalY };
+    return true;
+}
+
+// Carrega o nível 'level', preferindo o binário e caindo para o texto.
+static bool LoadLevelData(int level, LevelData& out) {
+    if (LoadLevelBinary(LevelPath(level, "lvl").c_str(), out)) return true;
+    if (ParseLevelText(LevelPath(level, "txt").c_str(), out)) return true;
+    TraceLog(LOG_WARNING, "LEVEL: Nível %d não encontrado em '%s'.", level, LevelsDir().c_str());
+    return false;
+}
+
+// Conta os níveis disponíveis (level1, level2, ... consecutivos). O resultado
+// é calculado uma vez e reaproveitado.
+static int AvailableLevels() {
+    static const int count = [] {
+        int n = 0;
+        while (true) {
+            MappedFile bin(LevelPath(n + 1, "lvl").c_str());
+            std::ifstream txt(LevelPath(n + 1, "txt"));
+            if (!bin.IsOpen() && !txt) break;
+            n++;
+        }
+        return n;
+    }();
+    return count;
+}
+
+// Carrega o próximo nível em uma thread de trabalho enquanto a tela de
+// transição está aberta. Quando o jogador confirma, os dados já prontos são
+// entregues por ponteiro e a simulação só troca os arrays.
+class LevelPrefetcher {
+public:
+    LevelPrefetcher() = default;
+    LevelPrefetcher(const LevelPrefetcher&) = delete;
+    LevelPrefetcher& operator=(const LevelPrefetcher&) = delete;
+    ~LevelPrefetcher() { Wait(); }
+
+    // Começa a carregar 'level' em segundo plano.
+    void Request(int level) {
+        Wait();
+        requestedLevel = level;
+        result = std::make_unique<LevelData>();
+        ready.store(false, std::memory_order_relaxed);
+        worker = std::thread([this, level] {
+            if (!LoadLevelData(level, *result)) result.reset();
+            ready.store(true, std::memory_order_release);
+        });
+    }
+
+    // Indica se o carregamento pedido já terminou.
+    bool Ready() const { return ready.load(std::memory_order_acquire); }
+
+    // Entrega os dados de 'level' se foram pedidos antes (esperando o fim do
+    // carregamento, caso ainda não tenha terminado), ou nullptr caso contrário
+    // ou se a leitura falhou.
+    std::unique_ptr<LevelData> Take(int level) {
+        if (requestedLevel != level) return nullptr;
+        Wait();
+        requestedLevel = 0;
+        return std::move(result);
+    }
+
+private:
+    std::thread worker;
+    std::atomic<bool> ready{ false };
+    std::unique_ptr<LevelData> result;
+    int requestedLevel = 0;
+
+    void Wait() {
+        if (worker.joinable()) worker.join();
+    }
+};
+
+// =============================================================================
+//                      NÚCLEO DE SIMULAÇÃO (SEM JANELA)
+// =============================================================================
+
+// Situação da partida após um tick de simulação.
+enum class SimStatus { RUNNING, LEVEL_COMPLETE, VICTORY, GAMEOVER };
+
+// Acontecimentos gerados durante um tick. A simulação não toca sons nem emite
+// partículas: ela apenas registra o que aconteceu, e a camada de apresentação
+// (Game) decide como reagir. Assim a mesma lógica roda com ou sem janela.
+enum class SimEventType { POWERUP_SPAWNED, POWERUP_COLLECTED, COIN_COLLECTED, GOAL_ENABLED, PLAYER_HIT, TIME_OVER };
+
+struct SimEvent {
+    SimEventType type;
+    Vector2 pos;
+    PowerUpType powerUp;
+};
+
+// Contém todo o estado de gameplay (jogador, paredes, moedas, power-ups e
+// objetivo) e avança a partida um tick por vez. Não depende de InitWindow,
+// InitAudioDevice nem do teclado, podendo rodar tão rápido quanto a CPU permitir.
+class Simulation {
+public:
+    Player player;
+    WallStore walls;
+    EntityWorld world; // Moedas e power-ups.
+    Objetivo* objetivo = nullptr;
+    int currentLevel = 1;
+    // Quantidade de níveis encontrados em "levels/" (ao menos 1).
+    const int maxLevels = std::max(AvailableLevels(), 1);
+    float totalGameTime = 0.0f;
+    const float initialGameTime = 180.0f;
+    int score = 0;
+    SimStatus status = SimStatus::RUNNING;
+
+    // Toda a aleatoriedade da partida vem deste gerador, semeado em StartGame().
+    Random rng;
+    uint32_t seed = 0;
+
+    // Eventos do último tick, consumidos por quem chamou Step().
+    std::vector<SimEvent> events;
+
+    // Broad-phase, indexada pelo id da entidade: moedas só saem da grade ao
+    // serem coletadas e power-ups entram/saem ao surgir/serem coletados.
+    // As paredes não usam grade. Todas se movem a cada tick, então qualquer
+    // índice delas teria de ser atualizado em uma passada O(N) -- e essa
+    // passada já existe: o kernel SIMD que as move testa, parede a parede, a
+    // sobreposição e a caixa percorrida contra o jogador (UpdateAndCollide).
+    // Uma grade estática pelas faixas de movimento também não serve, pois
+    // paredes que andam na diagonal varrem a tela inteira.
+    SpatialHash coinGrid;
+    SpatialHash powerupGrid;
+    int coinsRemaining = 0;
+
+    // Pool de threads para os sistemas independentes do tick (opcional; sem
+    // ele tudo roda na thread que chama Step()). O resultado é o mesmo.
+    JobSystem* jobs = nullptr;
+    std::vector<uint8_t> spawnDue; // Marcas de TickSpawnTimers, uma por power-up.
+    // Ids coletados em uma consulta à grade. Só saem da grade depois que a
+    // consulta termina, pois Remove() mexe nas células que ela percorre.
+    std::vector<int> collected;
+
+    // Versões para os retratos (SimSnapshot) só copiarem o que mudou:
+    // 'levelVersion' muda quando o nível é trocado (tamanho e tipo das
+    // paredes) e 'worldVersion' quando algo visível das moedas e power-ups
+    // muda (troca de nível, coleta, surgimento).
+    uint32_t levelVersion = 0;
+    uint32_t worldVersion = 0;
+
+    Simulation() = default;
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    ~Simulation() {
+        ClearLevel();
+    }
+
+    // Inicia uma nova partida a partir do primeiro nível. A mesma semente com
+    // as mesmas entradas reproduz exatamente a mesma partida. Retorna false se
+    // o nível não puder ser carregado (ver LoadLevel).
+    bool StartGame(uint32_t gameSeed) {
+        seed = gameSeed;
+        rng.Seed(gameSeed, RandomStream::GAMEPLAY);
+        currentLevel = 1;
+        totalGameTime = initialGameTime;
+        score = 0;
+        status = SimStatus::RUNNING;
+        return LoadLevel(currentLevel);
+    }
+
+    // Avança para o próximo nível após um LEVEL_COMPLETE. Se 'preloaded'
+    // for informado (ver LevelPrefetcher), usa esses dados em vez de ler o arquivo.
+    bool NextLevel(LevelData* preloaded = nullptr) {
+        currentLevel++;
+        status = SimStatus::RUNNING;
+        return LoadLevel(currentLevel, preloaded);
+    }
+
+    // Limpa todas as entidades do nível atual para preparar um novo nível.
+    void ClearLevel() {
+        walls.Clear();
+        world.Clear();
+        delete objetivo;
+        objetivo = nullptr;
+        levelVersion++;
+        worldVersion++;
+    }
+
+    // Carrega o nível 'level' do arquivo em "levels/" (ou usa 'preloaded',
+    // já carregado) e cria suas entidades. Se o arquivo faltar ou estiver
+    // corrompido, retorna false e o nível fica vazio: quem chamou não deve
+    // rodar Step() nesse estado (o objetivo, sem moedas, já nasceria aberto).
+    bool LoadLevel(int level, LevelData* preloaded = nullptr) {
+        ClearLevel();
+        player.Reset();
+
+        if (preloaded) {
+            ApplyLevel(*preloaded);
+            return true;
+        }
+        LevelData data;
+        if (!LoadLevelData(level, data)) return false;
+        ApplyLevel(data);
+        return true;
+    }
+
+    // Cria as entidades da simulação a partir dos dados de um nível. Os arrays
+    // de paredes são apenas transferidos (sem cópia); moedas e power-ups viram
+    // entidades do mundo, com os arrays de componentes reservados de uma vez.
+    void ApplyLevel(LevelData& data) {
+        world.Reserve(data.coins.size() + data.powerups.size());
+        for (const Vector2& c : data.coins) world.CreateCoin(c.x, c.y, rng);
+
+        objetivo = new Objetivo(data.goal.x, data.goal.y);
+        objetivo->enabled = false;
+
+        for (PowerUpType t : data.powerups) world.CreatePowerUp(t, rng);
+
+        walls = std::move(data.walls);
+
+        BuildSpatialIndex();
+    }
+
+    // Reconstrói as grades espaciais a partir das entidades do nível atual.
+    void BuildSpatialIndex() {
+        coinGrid.Reset((int)world.Count());
+        powerupGrid.Reset((int)world.Count());
+        coinsRemaining = 0;
+        const auto& collectibles = world.collectibles;
+        for (size_t i = 0; i < collectibles.Size(); i++) {
+            if (!collectibles.dense[i].active) continue;
+            EntityId e = collectibles.owners[i];
+            if (collectibles.dense[i].kind == CollectibleKind::COIN) {
+                coinGrid.Insert((int)e, world.transforms.Get(e).rect);
+                coinsRemaining++;
+            } else {
+                powerupGrid.Insert((int)e, world.transforms.Get(e).rect);
+            }
+        }
+    }
+
+    // Avança a partida em um tick de 'delta' segundos com a entrada fornecida.
+    // Os eventos ocorridos ficam disponíveis em 'events' até o próximo Step().
+    SimStatus Step(const InputState& input, float delta) {
+        events.clear();
+        if (status != SimStatus::RUNNING) return status;
+
+        totalGameTime -= delta;
+
+        // Verifica se o tempo acabou.
+        if (totalGameTime <= 0) {
+            status = SimStatus::GAMEOVER;
+            events.push_back({ SimEventType::TIME_OVER, Center(player.rect), PowerUpType::LIFE });
+            return status;
+        }
+
+        player.Update(delta, input);
+
+        // Movimento das paredes e timers de reaparecimento não dependem um do
+        // outro nem da coleta (as paredes só leem o retângulo do jogador, que a
+        // coleta não muda), então rodam em paralelo. Os resultados são aplicados
+        // depois, na thread atual e sempre na mesma ordem: eventos, sorteios e
+        // pontuação saem idênticos aos da execução em uma thread só.
+        int wallHits = 0;
+        spawnDue.resize(world.spawners.Size());
+        JobSystem* pool = walls.Size() + world.spawners.Size() > JOB_GRAIN ? jobs : nullptr;
+        ParallelInvoke(pool,
+            [&] {
+                // Atualiza todas as paredes e verifica colisões com o jogador na mesma passada.
+                ProfileScope scope(ProfilePhase::SIM_WALLS);
+                wallHits = walls.UpdateAndCollide(delta, player.prevRect, player.rect, jobs);
+            },
+            [&] {
+                ProfileScope scope(ProfilePhase::SIM_POWERUPS);
+                ParallelFor(jobs, world.spawners.Size(), JOB_GRAIN, [&](size_t begin, size_t end) {
+                    TickSpawnTimers(world, delta, begin, end, spawnDue.data());
+                });
+            });
+
+        // Os power-ups cujo timer zerou surgem; a coleta só é testada contra os
+        // que a grade aponta perto do jogador.
+        {
+            ProfileScope scope(ProfilePhase::SIM_POWERUPS);
+            SpawnDue(world, spawnDue.data(), rng, [&](EntityId e) {
+                Rectangle rect = world.transforms.Get(e).rect;
+                powerupGrid.Insert((int)e, rect);
+                worldVersion++;
+                events.push_back({ SimEventType::POWERUP_SPAWNED, Center(rect), world.collectibles.Get(e).powerUp });
+            });
+            collected.clear();
+            powerupGrid.Query(player.rect, [&](int i) {
+                if (TryCollect(world, (EntityId)i, player)) collected.push_back(i);
+            });
+            if (!collected.empty()) worldVersion++;
+            for (int i : collected) {
+                powerupGrid.Remove(i);
+                events.push_back({ SimEventType::POWERUP_COLLECTED, Center(world.transforms.Get((EntityId)i).rect), world.collectibles.Get((EntityId)i).powerUp });
+            }
+        }
+
+        {
+            ProfileScope scope(ProfilePhase::SIM_COINS);
+            collected.clear();
+            coinGrid.Query(player.rect, [&](int i) {
+                if (TryCollect(world, (EntityId)i, player)) collected.push_back(i);
+            });
+            if (!collected.empty()) worldVersion++;
+            for (int i : collected) {
+                coinGrid.Remove(i);
+                coinsRemaining--;
+                score += 100;
+                events.push_back({ SimEventType::COIN_COLLECTED, Center(world.transforms.Get((EntityId)i).rect), PowerUpType::LIFE });
+            }
+        }
+
+        // Habilita o objetivo se todas as moedas foram coletadas.
+        if (objetivo && !objetivo->enabled && coinsRemaining == 0) {
+            objetivo->Enable();
+            events.push_back({ SimEventType::GOAL_ENABLED, Center(objetivo->rect), PowerUpType::LIFE });
+        }
+        if (objetivo) objetivo->Update(delta);
+
+        if (player.invincibilityTimer <= 0 && player.shieldTimer <= 0) {
+            Vector2 hitPos = Center(player.rect);
+            bool hit = wallHits > 0;
+
+            // Sem sobreposição no fim do tick, o jogador ainda pode ter
+            // atravessado uma parede rápida (ou vice-versa) durante o tick.
+            float toi;
+            if (!hit && walls.SweepPlayer(player.prevRect, player.rect, &toi) >= 0) {
+                hit = true;
+                hitPos = Center(LerpRect(player.prevRect, player.rect, toi));
+            }
+
+            if (hit) {
+                player.TakeDamage();
+                events.push_back({ SimEventType::PLAYER_HIT, hitPos, PowerUpType::LIFE });
+            }
+        }
+
+        // Verifica a condição de Game Over (vidas esgotadas).
+        if (player.lives <= 0) status = SimStatus::GAMEOVER;
+        // Verifica se o jogador alcançou o objetivo final do nível, APENAS SE ESTIVER HABILITADO O CAMPO!
+        if (objetivo && objetivo->enabled && CheckCollisionRecs(player.rect, objetivo->rect)) {
+            score += 5000;
+            status = (currentLevel < maxLevels) ? SimStatus::LEVEL_COMPLETE : SimStatus::VICTORY;
+        }
+        return status;
+    }
+
+    // Centro de um retângulo, usado como posição dos eventos.
+    static Vector2 Center(Rectangle r) {
+        return { r.x + r.width / 2, r.y + r.height / 2 };
+    }
+};
+
+// =============================================================================
+//                                  REPLAYS
+// =============================================================================
+
+// Um replay guarda a semente da partida e a entrada de cada tick. Como toda a
+// aleatoriedade da simulação vem do gerador semeado em StartGame(), rodar as
+// mesmas entradas com a mesma semente reproduz a partida bit a bit. O estado
+// final também é gravado, para conferir a reprodução ("--replay arquivo").
+//
+// Layout do arquivo (little-endian):
+//   ReplayHeader
+//   runCount sequências de [entrada (uint8, InputState::ToBits)] [ticks (varint LEB128)]
+// Como as teclas ficam pressionadas por muitos ticks seguidos, as sequências
+// deixam o arquivo com poucos bytes por segundo de jogo.
+struct ReplayOutcome {
+    int32_t score = 0;
+    int32_t lives = 0;
+    float timeLeft = 0.0f;
+    int32_t level = 0;
+    uint32_t status = 0;
+
+    static ReplayOutcome From(const Simulation& sim) {
+        ReplayOutcome o;
+        o.score = sim.score;
+        o.lives = sim.player.lives;
+        o.timeLeft = sim.totalGameTime;
+        o.level = sim.currentLevel;
+        o.status = (uint32_t)sim.status;
+        return o;
+    }
+
+    bool operator==(const ReplayOutcome& other) const {
+        return score == other.score && lives == other.lives && timeLeft == other.timeLeft
+            && level == other.level && status == other.status;
+    }
+};
+
+struct ReplayHeader {
+    char magic[4];          // "LDSR"
+    uint32_t version;
+    uint32_t seed;
+    float tickDelta;
+    uint32_t tickCount;
+    uint32_t runCount;
+    ReplayOutcome outcome;
+};
+
+static const char REPLAY_MAGIC[4] = { 'L', 'D', 'S', 'R' };
+static const uint32_t REPLAY_VERSION = 1;
+static const char* LAST_REPLAY_PATH = "ultima_partida.replay";
+
+class Replay {
+public:
+    uint32_t seed = 0;
+    float tickDelta = 1.0f / DEFAULT_TICK_RATE;
+    std::vector<uint8_t> inputs;    // uma entrada por tick
+    ReplayOutcome outcome;
+
+    void Begin(uint32_t gameSeed, float delta) {
+        seed = gameSeed;
+        tickDelta = delta;
+        inputs.clear();
+        outcome = ReplayOutcome();
+    }
+
+    void Record(const InputState& input) { inputs.push_back(input.ToBits()); }
+
+    bool Save(const char* path) const {
+        std::vector<unsigned char> runs;
+        uint32_t runCount = 0;
+        for (size_t i = 0; i < inputs.size();) {
+            size_t j = i;
+            while (j < inputs.size() && inputs[j] == inputs[i]) j++;
+            runs.push_back(inputs[i]);
+            for (uint64_t n = j - i; ; n >>= 7) {
+                if (n < 0x80) { runs.push_back((unsigned char)n); break; }
+                runs.push_back((unsigned char)(n & 0x7F) | 0x80);
+            }
+            runCount++;
+            i = j;
+        }
+
+        ReplayHeader header = {};
+        memcpy(header.magic, REPLAY_MAGIC, sizeof(header.magic));
+        header.version = REPLAY_VERSION;
+        header.seed = seed;
+        header.tickDelta = tickDelta;
+        header.tickCount = (uint32_t)inputs.size();
+        header.runCount = runCount;
+        header.outcome = outcome;
+
+        std::ofstream out(path, std::ios::binary);
+        if (!out) return false;
+        out.write((const char*)&header, sizeof(header));
+        out.write((const char*)runs.data(), (std::streamsize)runs.size());
+        return (bool)out;
+    }
+
+    bool Load(const char* path) {
+        MappedFile file(path);
+        if (!file.IsOpen() || file.Size() < sizeof(ReplayHeader)) return false;
+
+        ReplayHeader header;
+        memcpy(&header, file.Data(), sizeof(header));
+        if (memcmp(header.magic, REPLAY_MAGIC, sizeof(header.magic)) != 0 || header.version != REPLAY_VERSION) {
+            TraceLog(LOG_WARNING, "REPLAY: %s: cabeçalho ou versão inválidos", path);
+            return false;
+        }
+
+        inputs.clear();
+        inputs.reserve(header.tickCount);
+        const unsigned char* p = file.Data() + sizeof(header);
+        const unsigned char* end = file.Data() + file.Size();
+        for (uint32_t r = 0; r < header.runCount; r++) {
+            if (p >= end) return false;
+            uint8_t bits = *p++;
+            uint64_t n = 0;
+            for (int shift = 0; ; shift += 7) {
+                if (p >= end || shift > 28) return false;
+                n |= (uint64_t)(*p & 0x7F) << shift;
+                if (!(*p++ & 0x80)) break;
+            }
+            if (inputs.size() + n > header.tickCount) return false;
+            inputs.insert(inputs.end(), (size_t)n, bits);
+        }
+        if (inputs.size() != header.tickCount) return false;
+
+        seed = header.seed;
+        tickDelta = header.tickDelta;
+        outcome = header.outcome;
+        return true;
+    }
+};
+
+// Reproduz um replay o mais rápido possível, sem janela, e grava o estado
+// final em 'out'. O próximo nível só é carregado quando há mais ticks, como no
+// jogo, em que a troca acontece ao sair da tela de transição. Retorna false
+// se algum nível não puder ser carregado.
+static bool PlayReplay(const Replay& replay, ReplayOutcome& out) {
+    Simulation sim;
+    if (!sim.StartGame(replay.seed)) return false;
+    for (uint8_t bits : replay.inputs) {
+        if (sim.status == SimStatus::LEVEL_COMPLETE && !sim.NextLevel()) return false;
+        sim.Step(InputState::FromBits(bits), replay.tickDelta);
+    }
+    out = ReplayOutcome::From(sim);
+    return true;
+}
+
+// "--replay arquivo": reproduz e confere o resultado com o gravado.
+static int RunReplayCheck(const char* path) {
+    Replay replay;
+    if (!replay.Load(path)) {
+        std::cerr << "Falha ao ler o replay " << path << "\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ReplayOutcome result;
+    if (!PlayReplay(replay, result)) {
+        std::cerr << "Falha ao carregar os niveis de " << LevelsDir() << "\n";
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto print = [](const char* label, const ReplayOutcome& o) {
+        std::cout << label << ": pontos " << o.score << ", vidas " << o.lives << ", tempo " << o.timeLeft
+                  << ", nivel " << o.level << ", status " << o.status << "\n";
+    };
+    std::cout << "Semente: " << replay.seed << "\n"
+              << "Ticks: " << replay.inputs.size() << " (" << seconds << " s)\n";
+    print("Gravado", replay.outcome);
+    print("Reproduzido", result);
+
+    bool match = result == replay.outcome;
+    std::cout << (match ? "OK: reproducao identica\n" : "DIVERGIU: o resultado nao bate com a gravacao\n");
+    return match ? 0 : 2;
+}
+
+// =============================================================================
+//                     THREAD DE SIMULAÇÃO E RETRATOS DE ESTADO
+// =============================================================================
+
+// Retrato do estado de gameplay necessário para desenhar um frame. A thread
+// de simulação monta um a cada tick; a thread de desenho só lê, nunca altera.
+struct SimSnapshot {
+    Player player;
+    // Só os arrays usados no desenho: posição atual e anterior (para a
+    // interpolação), tamanho e tipo. Velocidades e máscaras ficam vazias.
+    WallStore walls;
+    EntityWorld world;
+    Objetivo objetivo{ 0, 0 };
+    bool hasObjetivo = false;
+    int score = 0;
+    float totalGameTime = 0.0f;
+    int currentLevel = 1;
+    SimStatus status = SimStatus::RUNNING;
+    uint64_t tick = 0; // Ticks publicados desde que a thread foi criada.
+    std::chrono::steady_clock::time_point time; // Quando o retrato foi publicado.
+    // Versões da simulação copiadas por este slot (ver Simulation::levelVersion).
+    uint32_t levelVersion = 0;
+    uint32_t worldVersion = 0;
+
+    // Copia o estado da simulação. A cada tick só vai o que muda a cada tick:
+    // jogador, posições das paredes (todas se movem) e contadores. Tamanho e
+    // tipo das paredes só são copiados quando o nível muda, e moedas e
+    // power-ups quando alguma coleta ou surgimento muda o que é desenhado.
+    // Os arrays reaproveitam a capacidade do retrato que ocupava o slot antes,
+    // então não há alocação a cada tick.
+    void Capture(const Simulation& sim) {
+        player = sim.player;
+        if (levelVersion != sim.levelVersion) {
+            walls.w = sim.walls.w;
+            walls.h = sim.walls.h;
+            walls.kind = sim.walls.kind;
+            levelVersion = sim.levelVersion;
+        }
+        walls.x = sim.walls.x;
+        walls.y = sim.walls.y;
+        walls.prevX = sim.walls.prevX;
+        walls.prevY = sim.walls.prevY;
+        if (worldVersion != sim.worldVersion) {
+            world = sim.world;
+            worldVersion = sim.worldVersion;
+        }
+        hasObjetivo = sim.objetivo != nullptr;
+        if (hasObjetivo) objetivo = *sim.objetivo;
+        score = sim.score;
+        totalGameTime = sim.totalGameTime;
+        currentLevel = sim.currentLevel;
+        status = sim.status;
+        time = std::chrono::steady_clock::now();
+    }
+};
+
+// Buffer triplo sem trava para um escritor e um leitor: o escritor preenche
+// Back() e publica; o leitor pega o retrato mais novo com Acquire(). Como há
+// sempre um slot livre para cada lado, nenhum dos dois espera pelo outro, e o
+// slot que o leitor está usando nunca é sobrescrito.
+template <typename T>
+class TripleBuffer {
+public:
+    // Slot em que o escritor monta o próximo retrato.
+    T& Back() { return slots[back]; }
+
+    // Torna Back() o retrato mais novo e passa a escrever no slot que sobrou.
+    void Publish() {
+        uint8_t previous = middle.exchange((uint8_t)(back | FRESH), std::memory_order_acq_rel);
+        back = previous & INDEX;
+    }
+
+    // Passa a ler o retrato mais novo, se houver um ainda não lido.
+    const T& Acquire() {
+        if (middle.load(std::memory_order_relaxed) & FRESH) {
+            uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+            front = previous & INDEX;
+        }
+        return slots[front];
+    }
+
+    // Retrato pego no último Acquire().
+    const T& Front() const { return slots[front]; }
+
+private:
+    static constexpr uint8_t INDEX = 3;
+    static constexpr uint8_t FRESH = 4;
+
+    T slots[3] = {};
+    uint8_t back = 0;
+    uint8_t front = 1;
+    std::atomic<uint8_t> middle{ 2 };
+};
+
+// Roda a simulação em uma thread própria, em passo fixo de 'tickDelta'
+// segundos medido pelo relógio, independente do vsync e do tempo de desenho.
+// A entrada chega pela última InputState enviada com SetInput(); a saída são
+// os retratos em 'snapshots' e os eventos entregues por DrainEvents(). Para
+// mexer direto na simulação (nova partida, próximo nível, fim da gravação), a
+// thread principal usa Edit(), que roda entre dois ticks.
+class SimulationThread {
+public:
+    TripleBuffer<SimSnapshot> snapshots;
+
+    SimulationThread(Simulation& simulation, float tickDelta)
+        : sim(simulation),
+          tickDuration(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(tickDelta))),
+          delta(tickDelta) {
+        worker = std::thread([this] { Loop(); });
+    }
+
+    ~SimulationThread() { Stop(); }
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Encerra a thread. Depois disso a simulação só muda por Edit().
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+    void SetInput(const InputState& input) { inputBits.store(input.ToBits(), std::memory_order_relaxed); }
+
+    // Liga ou pausa os ticks. Ao religar, o relógio recomeça do zero, sem
+    // tentar recuperar o tempo em que ficou pausada.
+    void SetRunning(bool run) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = run;
+        }
+        wake.notify_all();
+    }
+
+    // Executa 'fn()' com a simulação parada entre dois ticks e publica um
+    // retrato do resultado. 'fn' pode alterar 'sim' e 'recorder' à vontade.
+    template <typename Fn>
+    void Edit(Fn&& fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            fn();
+            Publish();
+        }
+        wake.notify_all();
+    }
+
+    // Move para 'out' os eventos dos ticks desde a última chamada, em ordem.
+    void DrainEvents(std::vector<SimEvent>& out) {
+        out.clear();
+        std::lock_guard<std::mutex> lock(eventMutex);
+        out.swap(pendingEvents);
+    }
+
+    // Se não for nulo, recebe a entrada de cada tick (ver Replay).
+    Replay* recorder = nullptr;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Simulation& sim;
+    const Clock::duration tickDuration;
+    const float delta;
+    std::thread worker;
+    std::mutex mutex; // Protege 'sim', 'recorder', 'running' e 'quit'.
+    std::condition_variable wake;
+    bool running = false;
+    bool quit = false;
+    std::atomic<uint8_t> inputBits{ 0 };
+    uint64_t ticks = 0;
+
+    std::mutex eventMutex;
+    std::vector<SimEvent> pendingEvents;
+
+    bool Ticking() const { return running && sim.status == SimStatus::RUNNING; }
+
+    void Loop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!quit) {
+            wake.wait(lock, [this] { return quit || Ticking(); });
+            Clock::time_point next = Clock::now();
+            while (!quit && Ticking()) {
+                // Executa os ticks vencidos, até MAX_CATCHUP_STEPS; depois de
+                // um atraso maior o tempo excedente é descartado.
+                Clock::time_point now = Clock::now();
+                int steps = 0;
+                while (next <= now && Ticking() && steps < MAX_CATCHUP_STEPS) {
+                    Tick();
+                    next += tickDuration;
+                    steps++;
+                }
+                if (steps == MAX_CATCHUP_STEPS) next = now + tickDuration;
+                // Espera o próximo tick com a trava liberada, para Edit() e
+                // SetRunning() poderem entrar.
+                wake.wait_until(lock, next, [this] { return quit || !Ticking(); });
+            }
+        }
+    }
+
+    void Tick() {
+        ProfileScope scope(ProfilePhase::SIM_TICK);
+        InputState input = InputState::FromBits(inputBits.load(std::memory_order_relaxed));
+        if (recorder) recorder->Record(input);
+        sim.Step(input, delta);
+        if (!sim.events.empty()) {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            pendingEvents.insert(pendingEvents.end(), sim.events.begin(), sim.events.end());
+        }
+        Publish();
+    }
+
+    void Publish() {
+        SimSnapshot& snapshot = snapshots.Back();
+        snapshot.Capture(sim);
+        snapshot.tick = ++ticks;
+        snapshots.Publish();
+    }
+};
+
+// =============================================================================
+//                              SISTEMA DE PARTÍCULAS
+// =============================================================================
+
+// Descrição de uma partícula no momento da emissão. No sistema as partículas
+// são guardadas em arrays separados por atributo (ver ParticleSystem).
+struct Particle {
+    Vector2 pos, vel;
+    float life;
+    Color color;
+    float size;
+};
+
+// Integra posição e tempo de vida das 'n' primeiras partículas:
+// pos += vel * delta e life -= delta. Os arrays são independentes entre si,
+// então cada lane do SIMD é uma partícula.
+typedef void (*ParticleKernelFn)(float* posX, float* posY, const float* velX, const float* velY, float* life, size_t n, float delta);
+
+static void ParticleKernelScalar(float* posX, float* posY, const float* velX, const float* velY, float* life, size_t n, float delta) {
+    for (size_t i = 0; i < n; i++) {
+        posX[i] += velX[i] * delta;
+        posY[i] += velY[i] * delta;
+        life[i] -= delta;
+    }
+}
+
+#ifdef LABIRINTO_SIMD_X86
+static void ParticleKernelSSE2(float* posX, float* posY, const float* velX, const float* velY, float* life, size_t n, float delta) {
+    const __m128 dt = _mm_set1_ps(delta);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(posX + i, _mm_add_ps(_mm_loadu_ps(posX + i), _mm_mul_ps(_mm_loadu_ps(velX + i), dt)));
+        _mm_storeu_ps(posY + i, _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(_mm_loadu_ps(velY + i), dt)));
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), dt));
+    }
+    ParticleKernelScalar(posX + i, posY + i, velX + i, velY + i, life + i, n - i, delta);
+}
+
+__attribute__((target("avx2")))
+static void ParticleKernelAVX2(float* posX, float* posY, const float* velX, const float* velY, float* life, size_t n, float delta) {
+    const __m256 dt = _mm256_set1_ps(delta);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(posX + i, _mm256_add_ps(_mm256_loadu_ps(posX + i), _mm256_mul_ps(_mm256_loadu_ps(velX + i), dt)));
+        _mm256_storeu_ps(posY + i, _mm256_add_ps(_mm256_loadu_ps(posY + i), _mm256_mul_ps(_mm256_loadu_ps(velY + i), dt)));
+        _mm256_storeu_ps(life + i, _mm256_sub_ps(_mm256_loadu_ps(life + i), dt));
+    }
+    ParticleKernelScalar(posX + i, posY + i, velX + i, velY + i, life + i, n - i, delta);
+}
+#endif
+
+static ParticleKernelFn SelectParticleKernel() {
+#ifdef LABIRINTO_SIMD_X86
+    if (__builtin_cpu_supports("avx2")) return ParticleKernelAVX2;
+    return ParticleKernelSSE2;
+#else
+    return ParticleKernelScalar;
+#endif
+}
+
+static const ParticleKernelFn particleKernel = SelectParticleKernel();
+
+// O que fazer quando o sistema de partículas já está cheio e uma nova é emitida.
+enum class ParticleOverflow {
+    DROP_NEW, // A nova partícula é descartada.
+    // Uma partícula existente é substituída, escolhendo os slots em rodízio
+    // (O(1)). Não é necessariamente a mais antiga: a remoção das que morrem
+    // troca partículas de lugar no pool.
+    OVERWRITE_ROUND_ROBIN
+};
+
+// Pool de partículas com capacidade fixa, alocado uma única vez e guardado em
+// estrutura-de-arrays: posição, velocidade e vida (os dados lidos e escritos a
+// cada frame) ficam em arrays contíguos próprios, separados de cor e tamanho,
+// que só o desenho usa. As partículas vivas ficam compactadas em
+// [0, liveCount): emitir é escrever em 'liveCount' e remover é trocar com a
+// última viva (swap-remove), sem alocação nem erase por frame.
+class ParticleSystem {
+private:
+    std::vector<float> posX, posY, velX, velY, lifeLeft;
+    std::vector<float> sizes;
+    std::vector<Color> colors;
+    size_t liveCount = 0;
+    size_t replaceCursor = 0;
+    ParticleOverflow overflow;
+    Texture2D sprite = {}; // Círculo pré-renderizado usado no desenho em lote.
+    Random rng{ 0, RandomStream::PARTICLES };
+    static constexpr int EMIT_BATCH = 64;
+
+public:
+    ParticleSystem(size_t capacity = 4096, ParticleOverflow policy = ParticleOverflow::OVERWRITE_ROUND_ROBIN)
+        : posX(capacity), posY(capacity), velX(capacity), velY(capacity), lifeLeft(capacity),
+          sizes(capacity), colors(capacity), overflow(policy) {}
+
+    size_t Count() const { return liveCount; }
+    size_t Capacity() const { return posX.size(); }
+
+    // Remove todas as partículas (a capacidade do pool continua reservada).
+    void Clear() {
+        liveCount = 0;
+        replaceCursor = 0;
+    }
+
+    // Gera a textura do círculo de borda suave usada para desenhar as
+    // partículas. Precisa do contexto OpenGL (janela aberta).
+    void LoadSprite() {
+        const int spriteSize = 64;
+        const float radius = spriteSize / 2.0f;
+        std::vector<Color> pixels((size_t)(spriteSize * spriteSize));
+        for (int y = 0; y < spriteSize; y++) {
+            for (int x = 0; x < spriteSize; x++) {
+                float dx = x + 0.5f - radius;
+                float dy = y + 0.5f - radius;
+                // Alfa cheio no disco e queda de ~1.5 px na borda (antisserrilhado).
+                float alpha = std::clamp((radius - sqrtf(dx * dx + dy * dy)) / 1.5f, 0.0f, 1.0f);
+                pixels[(size_t)(y * spriteSize + x)] = { 255, 255, 255, (unsigned char)(alpha * 255.0f) };
+            }
+        }
+        Image image = { pixels.data(), spriteSize, spriteSize, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+        sprite = LoadTextureFromImage(image);
+        SetTextureFilter(sprite, TEXTURE_FILTER_BILINEAR);
+    }
+
+    void UnloadSprite() {
+        if (sprite.id != 0) UnloadTexture(sprite);
+        sprite = {};
+    }
+
+    // Emite um número específico de partículas de uma determinada posição com
+    // características definidas.
+    // Os atributos aleatórios são sorteados em blocos de EMIT_BATCH com o
+    // gerador cosmético do próprio sistema de partículas.
+    void Emit(Vector2 pos, int count, Color color, float speed, float size_min = 2.0f, float size_max = 5.0f) {
+        float angle[EMIT_BATCH], life[EMIT_BATCH], size[EMIT_BATCH];
+        for (int done = 0; done < count; done += EMIT_BATCH) {
+            int n = std::min(count - done, EMIT_BATCH);
+            rng.FillFloat(angle, (size_t)n, 0.0f, 2.0f * PI);
+            rng.FillFloat(life, (size_t)n, 0.3f, 0.8f);
+            rng.FillFloat(size, (size_t)n, size_min, size_max);
+            for (int i = 0; i < n; ++i) {
+                Vector2 vel = { sinf(angle[i]) * speed, cosf(angle[i]) * speed };
+                Spawn({ pos, vel, life[i], color, size[i] });
+            }
+        }
+    }
+
+    // Semeia a sequência das partículas (não afeta a simulação).
+    void Seed(uint64_t seed) { rng.Seed(seed, RandomStream::PARTICLES); }
+
+    // Atualiza a posição e o tempo de vida de todas as partículas. Com 'jobs',
+    // a integração roda em blocos paralelos; a compactação é sempre sequencial.
+    void Update(float delta, JobSystem* jobs = nullptr) {
+        ParallelFor(jobs, liveCount, JOB_GRAIN, [&](size_t begin, size_t end) {
+            particleKernel(posX.data() + begin, posY.data() + begin, velX.data() + begin, velY.data() + begin,
+                           lifeLeft.data() + begin, end - begin, delta);
+        });
+
+        // Compactação: as partículas expiradas são substituídas pela última viva.
+        size_t i = 0;
+        while (i < liveCount) {
+            if (lifeLeft[i] <= 0) Move(--liveCount, i);
+            else i++;
+        }
+    }
+
+    // Desenha todas as partículas ativas na tela, com efeitos de fade-out e diminuição de tamanho.
+    // Cada partícula vira um quad texturizado com o círculo pré-renderizado,
+    // todos enviados em um único bloco rlBegin/rlEnd: o lote do rlgl é
+    // desenhado de uma vez (só é dividido se passar do limite de vértices do lote).
+    void Draw() const {
+        if (sprite.id == 0) {
+            // Sem textura (ex.: falha ao criar), volta a desenhar círculo a círculo.
+            for (size_t i = 0; i < liveCount; i++) {
+                DrawCircleV({ posX[i], posY[i] }, sizes[i] * (lifeLeft[i] / 0.8f), Fade(colors[i], lifeLeft[i] / 0.8f));
+            }
+            return;
+        }
+
+        rlSetTexture(sprite.id);
+        rlBegin(RL_QUADS);
+        for (size_t i = 0; i < liveCount; i++) {
+            float fade = lifeLeft[i] / 0.8f;
+            float r = sizes[i] * fade;
+            float x = posX[i];
+            float y = posY[i];
+            Color c = Fade(colors[i], fade);
+
+            rlColor4ub(c.r, c.g, c.b, c.a);
+            rlTexCoord2f(0.0f, 0.0f); rlVertex2f(x - r, y - r);
+            rlTexCoord2f(0.0f, 1.0f); rlVertex2f(x - r, y + r);
+            rlTexCoord2f(1.0f, 1.0f); rlVertex2f(x + r, y + r);
+            rlTexCoord2f(1.0f, 0.0f); rlVertex2f(x + r, y - r);
+        }
+        rlEnd();
+        rlSetTexture(0);
+    }
+
+private:
+    void Spawn(const Particle& p) {
+        size_t slot;
+        if (liveCount < Capacity()) {
+            slot = liveCount++;
+        } else {
+            if (overflow == ParticleOverflow::DROP_NEW || Capacity() == 0) return;
+            slot = replaceCursor;
+            replaceCursor = (replaceCursor + 1) % Capacity();
+        }
+        posX[slot] = p.pos.x;
+        posY[slot] = p.pos.y;
+        velX[slot] = p.vel.x;
+        velY[slot] = p.vel.y;
+        lifeLeft[slot] = p.life;
+        sizes[slot] = p.size;
+        colors[slot] = p.color;
+    }
+
+    // Copia a partícula 'from' para a posição 'to' em todos os arrays.
+    void Move(size_t from, size_t to) {
+        posX[to] = posX[from];
+        posY[to] = posY[from];
+        velX[to] = velX[from];
+        velY[to] = velY[from];
+        lifeLeft[to] = lifeLeft[from];
+        sizes[to] = sizes[from];
+        colors[to] = colors[from];
+    }
+};
+
+// =============================================================================
+//                              CAMADAS DE FUNDO
+// =============================================================================
+
+// Hash inteiro de 32 bits (mistura de bits), usado para gerar as estrelas de
+// forma determinística a partir de uma semente, sem tocar no gerador global.
+static inline uint32_t Hash32(uint32_t x) {
+    x ^= x >> 16; x *= 0x7feb352dU;
+    x ^= x >> 15; x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+// Valor em [0, 1) derivado do hash de (semente, índice, canal).
+static inline float HashUnit(uint32_t seed, uint32_t index, uint32_t channel) {
+    return (Hash32(seed ^ Hash32(index * 4u + channel)) >> 8) * (1.0f / 16777216.0f);
+}
+
+// Fundo do jogo (névoa e estrelas) pré-renderizado em texturas. As camadas são
+// desenhadas uma única vez (e de novo só se a resolução mudar) sobre preto; a
+// cada frame cada camada é só um quad texturizado cujas cores são somadas à
+// tela (BLEND_ADD_COLORS), o que sobre o fundo preto equivale a desenhar as
+// formas diretamente.
+class BackgroundLayers {
+public:
+    explicit BackgroundLayers(uint32_t starSeed = 0x5eed, bool twinkle = true) : seed(starSeed), twinkleEnabled(twinkle) {}
+
+    // (Re)gera as texturas se ainda não existirem ou se a resolução mudou.
+    // Deve ser chamada fora de BeginDrawing/BeginMode2D.
+    void EnsureBaked() {
+        int w = GetScreenWidth();
+        int h = GetScreenHeight();
+        if (fog.id != 0 && w == bakedWidth && h == bakedHeight) return;
+        Unload();
+        bakedWidth = w;
+        bakedHeight = h;
+
+        // Névoa: dois degradês empilhados, que são rolados juntos como uma faixa.
+        fog = LoadRenderTexture(w, h * 2);
+        BeginTextureMode(fog);
+        ClearBackground(BACKGROUND_DEEPEST_DARK);
+        for (int i = 0; i < 2; i++) DrawRectangleGradientV(0, i * h, w, h, BACKGROUND_FOG_START, BACKGROUND_FOG_END);
+        EndTextureMode();
+
+        // Estrelas: duas variações de brilho das mesmas 200 estrelas; alternar
+        // entre elas faz o fundo cintilar sem sortear nada por frame.
+        for (int layer = 0; layer < 2; layer++) {
+            stars[layer] = LoadRenderTexture(w, h);
+            BeginTextureMode(stars[layer]);
+            ClearBackground(BACKGROUND_DEEPEST_DARK);
+            for (uint32_t i = 0; i < STAR_COUNT; i++) {
+                float x = HashUnit(seed, i, 0) * w;
+                float y = HashUnit(seed, i, 1) * h;
+                float size = HashUnit(seed, i, 2) < 0.5f ? 1.0f : 2.0f;
+                float alpha = (10.0f + HashUnit(seed + (uint32_t)layer + 1, i, 3) * 70.0f) / 255.0f;
+                DrawCircleV({ x, y }, size, Fade(UI_TEXT_COLOR, alpha));
+            }
+            EndTextureMode();
+        }
+    }
+
+    void Unload() {
+        if (fog.id != 0) UnloadRenderTexture(fog);
+        for (auto& layer : stars) {
+            if (layer.id != 0) UnloadRenderTexture(layer);
+            layer = {};
+        }
+        fog = {};
+    }
+
+    // Desenha as camadas cobrindo a área do jogo.
+    void Draw(double time) const {
+        if (fog.id == 0) return;
+
+        BeginBlendMode(BLEND_ADD_COLORS);
+
+        // Efeito de fundo de névoa subindo.
+        {
+            ProfileScope scope(ProfilePhase::DRAW_FOG);
+            float fogSpeed = 20.0f;
+            float timeOffset = fmod(time * fogSpeed, SCREEN_HEIGHT * 2);
+            float fogY = (float)SCREEN_HEIGHT - timeOffset;
+            // Texturas de render ficam de cabeça para baixo: altura negativa na origem.
+            Rectangle fogSrc = { 0, 0, (float)fog.texture.width, -(float)fog.texture.height };
+            DrawTexturePro(fog.texture, fogSrc, { 0, fogY, (float)SCREEN_WIDTH, SCREEN_HEIGHT * 2.0f }, { 0, 0 }, 0.0f, WHITE);
+        }
+
+        ProfileScope scope(ProfilePhase::DRAW_STARS);
+        Rectangle starSrc = { 0, 0, (float)bakedWidth, -(float)bakedHeight };
+        Rectangle screen = { 0, 0, (float)SCREEN_WIDTH, (float)SCREEN_HEIGHT };
+        if (!twinkleEnabled) {
+            DrawTexturePro(stars[0].texture, starSrc, screen, { 0, 0 }, 0.0f, WHITE);
+        } else {
+            // Com a soma de cores, a mistura entre as duas variações é feita
+            // escurecendo cada uma pelo tom de cinza da cor de tinta.
+            float t = 0.5f + 0.5f * sinf((float)time * 1.7f);
+            unsigned char a = (unsigned char)(255.0f * (1.0f - t));
+            unsigned char b = (unsigned char)(255.0f * t);
+            DrawTexturePro(stars[0].texture, starSrc, screen, { 0, 0 }, 0.0f, { a, a, a, 255 });
+            DrawTexturePro(stars[1].texture, starSrc, screen, { 0, 0 }, 0.0f, { b, b, b, 255 });
+        }
+
+        EndBlendMode();
+    }
+
+private:
+    static constexpr uint32_t STAR_COUNT = 200;
+
+    uint32_t seed;
+    bool twinkleEnabled;
+    int bakedWidth = 0;
+    int bakedHeight = 0;
+    RenderTexture2D fog = {};
+    RenderTexture2D stars[2] = {};
+};
+
+// =============================================================================
+//                          CACHE DE SONS DECODIFICADOS
+// =============================================================================
+
+// Decodificar MP3 domina o tempo de inicialização. Na primeira execução cada
+// efeito sonoro é decodificado normalmente e o PCM resultante é gravado ao lado
+// do original ("assets/hit.mp3" -> "assets/hit.mp3.pcm"). Nas execuções
+// seguintes o PCM é carregado com um único mmap, desde que o hash do arquivo de
+// origem gravado no cache ainda bata; se o MP3 mudar, o cache é refeito.
+//
+// Layout do cache (little-endian): SoundCacheHeader seguido das amostras
+// intercaladas, frameCount * channels * sampleSize/8 bytes.
+struct SoundCacheHeader {
+    char magic[4];          // "LDSP"
+    uint32_t version;
+    uint64_t sourceHash;    // FNV-1a de 64 bits do arquivo de origem
+    uint32_t frameCount;
+    uint32_t sampleRate;
+    uint32_t sampleSize;
+    uint32_t channels;
+};
+
+static const char SOUND_CACHE_MAGIC[4] = { 'L', 'D', 'S', 'P' };
+static const uint32_t SOUND_CACHE_VERSION = 1;
+
+static uint64_t HashBytes(const unsigned char* data, size_t size) {
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        h ^= data[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static size_t WaveDataSize(const Wave& wave) {
+    return (size_t)wave.frameCount * wave.channels * (wave.sampleSize / 8);
+}
+
+// Interpreta um bloco no formato do cache. Em 'out.data' fica um ponteiro para
+// as amostras dentro do próprio bloco, sem cópia. Se 'sourceHash' não for
+// nulo, o bloco só é aceito quando foi gerado a partir dessa versão da origem.
+static bool ParseWaveCache(const unsigned char* data, size_t size, const uint64_t* sourceHash, Wave& out) {
+    if (size < sizeof(SoundCacheHeader)) return false;
+
+    SoundCacheHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, SOUND_CACHE_MAGIC, sizeof(header.magic)) != 0 || header.version != SOUND_CACHE_VERSION
+        || (sourceHash && header.sourceHash != *sourceHash)) {
+        return false;
+    }
+
+    Wave wave = {};
+    wave.frameCount = header.frameCount;
+    wave.sampleRate = header.sampleRate;
+    wave.sampleSize = header.sampleSize;
+    wave.channels = header.channels;
+    size_t bytes = WaveDataSize(wave);
+    if (bytes == 0 || size != sizeof(header) + bytes) return false;
+
+    wave.data = (void*)(data + sizeof(header));
+    out = wave;
+    return true;
+}
+
+// Tenta carregar o PCM do cache. Falha se o arquivo não existir, estiver
+// truncado ou tiver sido gerado a partir de outra versão da origem.
+static bool LoadWaveCache(const char* cachePath, uint64_t sourceHash, Wave& out) {
+    MappedFile file(cachePath);
+    Wave wave = {};
+    if (!file.IsOpen() || !ParseWaveCache(file.Data(), file.Size(), &sourceHash, wave)) return false;
+
+    // O Wave é liberado depois com UnloadWave, então os dados precisam vir do alocador do raylib.
+    size_t bytes = WaveDataSize(wave);
+    void* samples = RL_MALLOC(bytes);
+    memcpy(samples, wave.data, bytes);
+    wave.data = samples;
+    out = wave;
+    return true;
+}
+
+static bool WriteWaveCache(const char* cachePath, uint64_t sourceHash, const Wave& wave) {
+    std::ofstream out(cachePath, std::ios::binary);
+    if (!out) return false;
+
+    SoundCacheHeader header = {};
+    memcpy(header.magic, SOUND_CACHE_MAGIC, sizeof(header.magic));
+    header.version = SOUND_CACHE_VERSION;
+    header.sourceHash = sourceHash;
+    header.frameCount = wave.frameCount;
+    header.sampleRate = wave.sampleRate;
+    header.sampleSize = wave.sampleSize;
+    header.channels = wave.channels;
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)wave.data, (std::streamsize)WaveDataSize(wave));
+    return (bool)out;
+}
+
+// Substituto de LoadWave que passa pelo cache de PCM. Seguro para chamar em
+// threads de trabalho: só usa arquivos e decodificação na CPU.
+static Wave LoadWaveCached(const char* path) {
+    MappedFile source(path);
+    if (!source.IsOpen()) return LoadWave(path);
+
+    uint64_t hash = HashBytes(source.Data(), source.Size());
+    std::string cachePath = std::string(path) + ".pcm";
+    Wave wave = {};
+    if (LoadWaveCache(cachePath.c_str(), hash, wave)) return wave;
+
+    wave = LoadWaveFromMemory(GetFileExtension(path), source.Data(), (int)source.Size());
+    if (wave.data != nullptr && !WriteWaveCache(cachePath.c_str(), hash, wave)) {
+        TraceLog(LOG_WARNING, "WAVE: Não foi possível gravar o cache '%s'", cachePath.c_str());
+    }
+    return wave;
+}
+
+// =============================================================================
+//                            PACOTE DE RECURSOS
+// =============================================================================
+
+// Todos os arquivos de "assets/" podem ser empacotados em um único
+// "assets.pak", gerado com "--build-pack assets assets.pak". Em vez de abrir
+// onze arquivos, o jogo mapeia o pacote uma vez e decodifica cada recurso
+// direto da memória mapeada. Os efeitos sonoros já vão decodificados para o
+// pacote (no formato do cache de PCM, com o nome "arquivo.mp3.pcm"), então as
+// amostras são entregues ao LoadSoundFromWave sem cópia nem decodificação.
+// Sem o pacote, os recursos são lidos um a um de "assets/".
+//
+// Layout (little-endian):
+//   PackHeader
+//   PackEntry[entryCount], ordenadas por nome
+//   blobs, cada um começando em um offset múltiplo de PACK_ALIGNMENT
+struct PackHeader {
+    char magic[4];          // "LDSA"
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct PackEntry {
+    char name[48];          // nome relativo a "assets/", terminado em '\0'
+    uint64_t offset;        // a partir do início do arquivo
+    uint64_t size;
+};
+
+static const char PACK_MAGIC[4] = { 'L', 'D', 'S', 'A' };
+static const uint32_t PACK_VERSION = 1;
+static const size_t PACK_ALIGNMENT = 16;
+static const char* PACK_PATH = "assets.pak";
+static const char* ASSETS_DIR = "assets";
+// Música de fundo: transmitida em partes durante o jogo (LoadMusicStream), por
+// isso vai para o pacote no formato original em vez de decodificada.
+static const char* MUSIC_ASSET = "music.mp3";
+
+static inline size_t AlignPack(size_t n) { return (n + PACK_ALIGNMENT - 1) & ~(PACK_ALIGNMENT - 1); }
+
+// Pacote mapeado em memória. As buscas devolvem ponteiros para dentro do
+// mapeamento, válidos enquanto o pacote estiver aberto.
+class AssetArchive {
+public:
+    // Mapeia e valida o pacote. Retorna false se ele não existir ou estiver corrompido.
+    bool Open(const char* path) {
+        entries = nullptr;
+        entryCount = 0;
+        if (!file.Open(path)) return false;
+
+        PackHeader header;
+        if (file.Size() < sizeof(header)) return Reject(path);
+        memcpy(&header, file.Data(), sizeof(header));
+        if (memcmp(header.magic, PACK_MAGIC, sizeof(header.magic)) != 0 || header.version != PACK_VERSION) return Reject(path);
+        if (sizeof(header) + (size_t)header.entryCount * sizeof(PackEntry) > file.Size()) return Reject(path);
+
+        const PackEntry* table = (const PackEntry*)(file.Data() + sizeof(header));
+        for (uint32_t i = 0; i < header.entryCount; i++) {
+            if (table[i].offset > file.Size() || table[i].size > file.Size() - table[i].offset) return Reject(path);
+        }
+        entries = table;
+        entryCount = header.entryCount;
+        TraceLog(LOG_INFO, "PACK: '%s' mapeado com %u recursos.", path, entryCount);
+        return true;
+    }
+
+    bool IsOpen() const { return entries != nullptr; }
+
+    // Procura um recurso pelo nome (busca binária na tabela ordenada).
+    bool Find(const char* name, const unsigned char** data, size_t* size) const {
+        const PackEntry* end = entries + entryCount;
+        const PackEntry* it = std::lower_bound(entries, end, name, [](const PackEntry& e, const char* n) {
+            return strncmp(e.name, n, sizeof(e.name)) < 0;
+        });
+        if (it == end || strncmp(it->name, name, sizeof(it->name)) != 0) return false;
+        *data = file.Data() + it->offset;
+        *size = (size_t)it->size;
+        return true;
+    }
+
+    // Indica se o ponteiro aponta para dentro do pacote (e portanto não deve ser liberado).
+    bool Owns(const void* p) const {
+        const unsigned char* b = (const unsigned char*)p;
+        return IsOpen() && b >= file.Data() && b < file.Data() + file.Size();
+    }
+
+private:
+    MappedFile file;
+    const PackEntry* entries = nullptr;
+    uint32_t entryCount = 0;
+
+    bool Reject(const char* path) {
+        TraceLog(LOG_WARNING, "PACK: %s: cabeçalho ou tabela inválidos", path);
+        file.Close();
+        return false;
+    }
+};
+
+// Gera o pacote a partir de todos os arquivos de uma pasta. Efeitos sonoros
+// são decodificados aqui para que o jogo não precise decodificá-los na carga;
+// a música (MUSIC_ASSET) vai como está, pois é decodificada aos poucos ao tocar.
+static bool WriteAssetPack(const char* directory, const char* path) {
+    struct Blob { std::string name; std::vector<unsigned char> bytes; };
+    std::vector<Blob> blobs;
+
+    FilePathList files = LoadDirectoryFiles(directory);
+    for (unsigned int i = 0; i < files.count; i++) {
+        const char* filePath = files.paths[i];
+        const char* name = GetFileName(filePath);
+        if (IsFileExtension(name, ".pcm")) continue;
+        if (strlen(name) >= sizeof(PackEntry::name) - 4) {
+            TraceLog(LOG_WARNING, "PACK: nome longo demais, ignorado: %s", name);
+            continue;
+        }
+
+        MappedFile source(filePath);
+        if (!source.IsOpen()) continue;
+        Blob blob;
+        if (IsFileExtension(name, ".mp3;.wav;.ogg;.flac;.qoa") && strcmp(name, MUSIC_ASSET) != 0) {
+            Wave wave = LoadWaveFromMemory(GetFileExtension(name), source.Data(), (int)source.Size());
+            if (wave.data == nullptr) continue;
+            SoundCacheHeader header = {};
+            memcpy(header.magic, SOUND_CACHE_MAGIC, sizeof(header.magic));
+            header.version = SOUND_CACHE_VERSION;
+            header.sourceHash = HashBytes(source.Data(), source.Size());
+            header.frameCount = wave.frameCount;
+            header.sampleRate = wave.sampleRate;
+            header.sampleSize = wave.sampleSize;
+            header.channels = wave.channels;
+            const unsigned char* samples = (const unsigned char*)wave.data;
+            blob.name = std::string(name) + ".pcm";
+            blob.bytes.assign((const unsigned char*)&header, (const unsigned char*)&header + sizeof(header));
+            blob.bytes.insert(blob.bytes.end(), samples, samples + WaveDataSize(wave));
+            UnloadWave(wave);
+        } else {
+            blob.name = name;
+            blob.bytes.assign(source.Data(), source.Data() + source.Size());
+        }
+        blobs.push_back(std::move(blob));
+    }
+    UnloadDirectoryFiles(files);
+
+    std::sort(blobs.begin(), blobs.end(), [](const Blob& a, const Blob& b) { return a.name < b.name; });
+
+    PackHeader header = {};
+    memcpy(header.magic, PACK_MAGIC, sizeof(header.magic));
+    header.version = PACK_VERSION;
+    header.entryCount = (uint32_t)blobs.size();
+
+    std::vector<PackEntry> table(blobs.size());
+    size_t offset = AlignPack(sizeof(header) + table.size() * sizeof(PackEntry));
+    for (size_t i = 0; i < blobs.size(); i++) {
+        table[i] = {};
+        strncpy(table[i].name, blobs[i].name.c_str(), sizeof(table[i].name) - 1);
+        table[i].offset = offset;
+        table[i].size = blobs[i].bytes.size();
+        offset = AlignPack(offset + blobs[i].bytes.size());
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)table.data(), (std::streamsize)(table.size() * sizeof(PackEntry)));
+    const char padding[PACK_ALIGNMENT] = {};
+    size_t written = sizeof(header) + table.size() * sizeof(PackEntry);
+    for (size_t i = 0; i < blobs.size(); i++) {
+        out.write(padding, (std::streamsize)(table[i].offset - written));
+        out.write((const char*)blobs[i].bytes.data(), (std::streamsize)blobs[i].bytes.size());
+        written = table[i].offset + blobs[i].bytes.size();
+    }
+    return (bool)out;
+}
+
+// Caminho de um recurso solto na pasta de recursos.
+static std::string AssetPath(const char* name) {
+    return std::string(ASSETS_DIR) + "/" + name;
+}
+
+// Carrega um som: do pacote (PCM já decodificado, sem cópia), ou então do
+// arquivo solto passando pelo cache de PCM. Um Wave cujo 'data' aponta para o
+// pacote (AssetArchive::Owns) não deve ser passado a UnloadWave.
+static Wave LoadWaveAsset(const AssetArchive& pack, const char* name) {
+    const unsigned char* data;
+    size_t size;
+    Wave wave = {};
+    if (pack.IsOpen() && pack.Find((std::string(name) + ".pcm").c_str(), &data, &size)
+        && ParseWaveCache(data, size, nullptr, wave)) {
+        return wave;
+    }
+    if (pack.IsOpen() && pack.Find(name, &data, &size)) {
+        return LoadWaveFromMemory(GetFileExtension(name), data, (int)size);
+    }
+    return LoadWaveCached(AssetPath(name).c_str());
+}
+
+static Image LoadImageAsset(const AssetArchive& pack, const char* name) {
+    const unsigned char* data;
+    size_t size;
+    if (pack.IsOpen() && pack.Find(name, &data, &size)) {
+        return LoadImageFromMemory(GetFileExtension(name), data, (int)size);
+    }
+    return LoadImage(AssetPath(name).c_str());
+}
+
+// =============================================================================
+//                      CARREGAMENTO ASSÍNCRONO DE RECURSOS
 // =============================================================================
 
-// Classe para Moedas do jogo
-class Coin : public Entidade {
+// Carrega recursos em paralelo. Cada recurso é um job com duas etapas:
+// 'decode' roda em uma thread de trabalho (leitura do arquivo e decodificação
+// na CPU: MP3 -> PCM, PNG -> pixels, TTF -> atlas de glifos) e 'upload' roda
+// na thread principal (criação de texturas na GPU e de buffers de áudio), pois
+// OpenGL e o dispositivo de áudio só podem ser usados por ela.
+class AssetLoader {
 public:
-    bool active;
-    float pulse;
-    // Construtor: Inicializa a posição e tamanho da moeda.
-    Coin(float x, float y) {
-        rect = { x, y, 15, 15 };
-        active = true;
-        pulse = (float)GetRandomValue(0, 100);
-    }
-    // Desenha a moeda se estiver ativa, com um efeito de pulsação de tamanho.
-    void Draw() const override {
-        if (active) {
-            float sizeFactor = 1.0f + 0.15f * sinf(GetTime() * 5.0f + pulse);
-            float glowAlpha = 0.4f + 0.4f * sinf(GetTime()*10.0f + pulse);
-
-            // Brilho externo da moeda.
-            DrawCircle((int)(rect.x + rect.width / 2), (int)(rect.y + rect.height / 2), (rect.width / 2) * sizeFactor * 1.8f, Fade(COIN_GLOW_COLOR, glowAlpha));
-
-            DrawCircle((int)(rect.x + rect.width / 2), (int)(rect.y + rect.height / 2), (rect.width / 2) * sizeFactor, COIN_COLOR);
+    AssetLoader() = default;
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+    ~AssetLoader() { Join(); }
+
+    // Registra um recurso e retorna seu identificador. 'required' indica que
+    // o jogo não pode começar sem ele. Deve ser chamado antes de Start().
+    int Add(const char* name, bool required, std::function<void()> decode, std::function<void()> upload) {
+        auto job = std::make_unique<Job>();
+        job->name = name;
+        job->required = required;
+        job->decode = std::move(decode);
+        job->upload = std::move(upload);
+        jobs.push_back(std::move(job));
+        return (int)jobs.size() - 1;
+    }
 
-            // Efeito de orbe/energia no centro da moeda.
-            DrawCircle((int)(rect.x + rect.width / 2), (int)(rect.y + rect.height / 2), (rect.width / 2) * sizeFactor * 0.4f, Fade(UI_HIGHLIGHT_COLOR, glowAlpha * 0.8f));
+    // Dispara as threads de trabalho, que pegam os jobs em ordem até acabarem.
+    void Start() {
+        unsigned int threads = std::clamp(std::thread::hardware_concurrency(), 1u, 4u);
+        threads = std::min(threads, (unsigned int)std::max<size_t>(jobs.size(), 1));
+        for (unsigned int t = 0; t < threads; t++) {
+            workers.emplace_back([this] {
+                for (size_t i = next.fetch_add(1); i < jobs.size(); i = next.fetch_add(1)) {
+                    jobs[i]->decode();
+                    jobs[i]->decoded.store(true, std::memory_order_release);
+                }
+            });
         }
     }
 
-    // Coletar a moeda se o jogador colidir com ela.
-    bool TryCollect(Player& player) {
-        if (active && CheckCollisionRecs(player.rect, rect)) {
-            active = false;
-            return true;
+    // Chamado uma vez por frame na thread principal: envia para GPU/áudio os
+    // recursos que já terminaram de decodificar e os marca como prontos.
+    void Poll() {
+        for (auto& job : jobs) {
+            if (job->ready || !job->decoded.load(std::memory_order_acquire)) continue;
+            job->upload();
+            job->ready = true;
+            TraceLog(LOG_INFO, "ASSETS: '%s' pronto.", job->name);
         }
-        return false;
     }
-};
 
-// Classe para Power-Ups do jogo 
-class PowerUp : public Entidade {
-public:
-    bool active;
-    float spawnTimer;
-    PowerUpType type;
+    // Espera todas as decodificações e conclui os uploads pendentes.
+    void Finish() {
+        Join();
+        Poll();
+    }
 
-    // Construtor: Inicializa o tipo de power-up e define seu estado inicial.
-    PowerUp(PowerUpType t) : type(t) {
-        active = false;
-        spawnTimer = (float)GetRandomValue(8, 15);
-        rect = { 0, 0, 25, 25 };
+    bool Ready(int id) const { return jobs[id]->ready; }
+
+    // Indica se todos os recursos obrigatórios já estão prontos para uso.
+    bool RequiredReady() const {
+        for (const auto& job : jobs) {
+            if (job->required && !job->ready) return false;
+        }
+        return true;
     }
 
-    // Atualiza a lógica do power-up, incluindo seu reaparecimento.
-    void Update(float delta) override {
-        if (!active) {
-            spawnTimer -= delta;
-            if (spawnTimer <= 0) {
-                active = true;
-                // Define uma posição aleatória na tela, com margem das bordas.
-                rect.x = (float)GetRandomValue(100, SCREEN_WIDTH - 100);
-                rect.y = (float)GetRandomValue(100, SCREEN_HEIGHT - 100);
-                spawnTimer = (float)GetRandomValue(15, 25);
-            }
+    // Fração dos recursos já prontos, de 0 a 1.
+    float Progress() const {
+        if (jobs.empty()) return 1.0f;
+        int done = 0;
+        for (const auto& job : jobs) done += job->ready ? 1 : 0;
+        return (float)done / jobs.size();
+    }
+
+private:
+    struct Job {
+        const char* name;
+        bool required;
+        std::function<void()> decode;
+        std::function<void()> upload;
+        std::atomic<bool> decoded{ false };
+        bool ready = false;
+    };
+
+    std::vector<std::unique_ptr<Job>> jobs;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> next{ 0 };
+
+    void Join() {
+        for (auto& w : workers) {
+            if (w.joinable()) w.join();
         }
+        workers.clear();
     }
+};
 
-    // Desenha o power-up na tela acordando com o seu tipo.
-    void Draw() const override {
-        if (active) {
-            Color c;
-            const char* t;
-            Color glowColor = UI_HIGHLIGHT_COLOR;
+// Parte de CPU do carregamento de uma fonte TTF: rasteriza os glifos e monta
+// o atlas em uma imagem, como LoadFontEx faz, mas sem criar a textura. O TTF
+// vem do pacote quando ele existe, senão do arquivo solto.
+static Font DecodeFont(const AssetArchive& pack, const char* name, int fontSize, Image* atlas) {
+    Font font = {};
+    *atlas = {};
+    const unsigned char* data;
+    size_t size;
+    unsigned char* fileData = nullptr;
+    if (!pack.IsOpen() || !pack.Find(name, &data, &size)) {
+        int dataSize = 0;
+        fileData = LoadFileData(AssetPath(name).c_str(), &dataSize);
+        if (!fileData) return font;
+        data = fileData;
+        size = (size_t)dataSize;
+    }
 
-            if (type == PowerUpType::LIFE) { c = LIFE_POWERUP_COLOR; t = "L"; glowColor = LIFE_POWERUP_COLOR; }
-            else if (type == PowerUpType::SHIELD) { c = SHIELD_POWERUP_COLOR; t = "S"; glowColor = SHIELD_POWERUP_COLOR; }
-            else { c = SPEED_POWERUP_COLOR; t = "V"; glowColor = SPEED_POWERUP_COLOR; }
+    font.baseSize = fontSize;
+    font.glyphCount = 95;
+    font.glyphs = LoadFontData(data, (int)size, font.baseSize, nullptr, font.glyphCount, FONT_DEFAULT);
+    if (fileData) UnloadFileData(fileData);
+    if (!font.glyphs) return font;
+
+    font.glyphPadding = 4;
+    *atlas = GenImageFontAtlas(font.glyphs, &font.recs, font.glyphCount, font.baseSize, font.glyphPadding, 0);
+    for (int i = 0; i < font.glyphCount; i++) {
+        UnloadImage(font.glyphs[i].image);
+        font.glyphs[i].image = ImageFromImage(*atlas, font.recs[i]);
+    }
+    return font;
+}
 
-            float pulseAlpha = 0.2f + 0.2f * sinf(GetTime() * 12.0f);
+// =============================================================================
+//                          CACHE DE LAYOUT DE TEXTO
+// =============================================================================
 
-            // Brilho de fundo pulsante.
-            DrawCircle((int)(rect.x + rect.width / 2), (int)(rect.y + rect.height / 2), rect.width * 1.5f, Fade(glowColor, pulseAlpha));
+// Um texto já medido e com os quads dos glifos prontos. Os textos da interface
+// mudam raramente (a pontuação só em coletas, o tempo uma vez por segundo),
+// então medir com MeasureTextEx e montar a string com TextFormat a cada frame
+// é trabalho desperdiçado. Set() e SetFormatted() comparam a chave (fonte,
+// tamanho, espaçamento e texto) com a anterior e só refazem o layout quando
+// algo mudou; Draw() apenas envia os quads guardados em um único bloco rlgl.
+class TextLayout {
+public:
+    // Define o texto. Não faz nada se for igual ao que já está em cache.
+    void Set(const Font& font, const char* str, float size, float textSpacing) {
+        if (Matches(font, size, textSpacing) && text == str) return;
+        text = str;
+        Build(font, size, textSpacing);
+    }
 
-            // Desenha o fundo e a borda do power-up.
-            DrawRectangleRec(rect, c);
-            DrawRectangleLinesEx(rect, 2, Fade(UI_HIGHLIGHT_COLOR, 0.7f + 0.3f * sinf(GetTime() * 10.0f)));
+    // Define o texto a partir de um formato com um único inteiro. Só formata
+    // (e refaz o layout) quando o valor, o formato ou a fonte mudam.
+    void SetFormatted(const Font& font, const char* format, int value, float size, float textSpacing) {
+        if (Matches(font, size, textSpacing) && format == lastFormat && value == lastValue) return;
+        text = TextFormat(format, value);
+        Build(font, size, textSpacing);
+        lastFormat = format;
+        lastValue = value;
+    }
 
-            // Desenha o ícone/texto dentro do power-up.
-            Vector2 textSize = MeasureTextEx(GetFontDefault(), t, 20, 1);
-            DrawText(t, (int)(rect.x + (rect.width - textSize.x) / 2), (int)(rect.y + (rect.height - textSize.y) / 2), 20, UI_HIGHLIGHT_COLOR);
+    Vector2 Size() const { return measured; }
+
+    // Desenha o texto com o canto superior esquerdo em 'position'.
+    void Draw(Vector2 position, Color tint) const {
+        if (quads.empty()) return;
+        rlSetTexture(fontTexture);
+        rlBegin(RL_QUADS);
+        rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+        for (const GlyphQuad& q : quads) {
+            float x = position.x + q.x, y = position.y + q.y;
+            rlTexCoord2f(q.u0, q.v0); rlVertex2f(x, y);
+            rlTexCoord2f(q.u0, q.v1); rlVertex2f(x, y + q.h);
+            rlTexCoord2f(q.u1, q.v1); rlVertex2f(x + q.w, y + q.h);
+            rlTexCoord2f(q.u1, q.v0); rlVertex2f(x + q.w, y);
         }
+        rlEnd();
+        rlSetTexture(0);
+    }
+
+private:
+    // Posição relativa à origem do texto, tamanho e coordenadas de textura de um glifo.
+    struct GlyphQuad { float x, y, w, h, u0, v0, u1, v1; };
+
+    std::string text;
+    unsigned int fontTexture = 0;
+    float fontSize = 0;
+    float spacing = 0;
+    const char* lastFormat = nullptr;
+    int lastValue = 0;
+    Vector2 measured = { 0, 0 };
+    std::vector<GlyphQuad> quads;
+
+    // A fonte é identificada pela textura do atlas: muda quando a fonte
+    // personalizada termina de carregar e substitui a padrão.
+    bool Matches(const Font& font, float size, float textSpacing) const {
+        return font.texture.id == fontTexture && size == fontSize && textSpacing == spacing;
     }
 
-    // Tenta aplicar o efeito do power-up ao jogador se houver colisão.
-    bool TryCollect(Player& player) {
-        if (active && CheckCollisionRecs(player.rect, this->rect)) {
-            active = false;
-            // Aplica o efeito correspondente ao tipo de power-up.
-            if (type == PowerUpType::LIFE && player.lives < 3) player.lives++;
-            if (type == PowerUpType::SHIELD) player.shieldTimer = 5.0f;
-            if (type == PowerUpType::SPEED) {
-                player.speedBoostTimer = 4.0f;
-                player.currentSpeed = player.baseSpeed * 1.5f;
+    // Mede e monta os quads do mesmo jeito que DrawTextEx posiciona cada glifo.
+    void Build(const Font& font, float size, float textSpacing) {
+        fontTexture = font.texture.id;
+        fontSize = size;
+        spacing = textSpacing;
+        lastFormat = nullptr;
+        measured = MeasureTextEx(font, text.c_str(), size, textSpacing);
+        quads.clear();
+        if (font.texture.id == 0 || font.baseSize == 0) return;
+
+        float scale = size / font.baseSize;
+        float pad = (float)font.glyphPadding;
+        float texW = (float)font.texture.width, texH = (float)font.texture.height;
+        float offsetX = 0.0f, offsetY = 0.0f;
+        const char* p = text.c_str();
+        while (*p) {
+            int bytes = 0;
+            int codepoint = GetCodepointNext(p, &bytes);
+            p += bytes;
+            if (codepoint == '\n') {
+                offsetX = 0.0f;
+                offsetY += size + 2.0f;
+                continue;
             }
-            return true;
+
+            int index = GetGlyphIndex(font, codepoint);
+            const Rectangle& rec = font.recs[index];
+            if (codepoint != ' ' && codepoint != '\t') {
+                GlyphQuad q;
+                q.x = offsetX + (font.glyphs[index].offsetX - pad) * scale;
+                q.y = offsetY + (font.glyphs[index].offsetY - pad) * scale;
+                q.w = (rec.width + 2.0f * pad) * scale;
+                q.h = (rec.height + 2.0f * pad) * scale;
+                q.u0 = (rec.x - pad) / texW;
+                q.v0 = (rec.y - pad) / texH;
+                q.u1 = (rec.x + rec.width + pad) / texW;
+                q.v1 = (rec.y + rec.height + pad) / texH;
+                quads.push_back(q);
+            }
+            float advance = font.glyphs[index].advanceX != 0 ? (float)font.glyphs[index].advanceX : rec.width;
+            offsetX += advance * scale + spacing;
         }
-        return false;
     }
 };
 
 // =============================================================================
-//                              SISTEMA DE PARTÍCULAS
+//                        CAMADA ESTÁTICA DE INTERFACE
 // =============================================================================
 
-struct Particle {
-    Vector2 pos, vel;
-    float life;
-    Color color;
-    float size;
-};
-
-class ParticleSystem {
-private:
-    std::vector<Particle> particles;
+// Conteúdo de tela que não muda de um frame para o outro (título e assinatura
+// do menu), gravado uma vez em uma textura de render e depois desenhado como
+// um único quad. Só é regravado quando é invalidado (mudança de tamanho da
+// janela) ou quando a fonte troca, por exemplo ao terminar de carregar.
+class CachedLayer {
 public:
-    // Emite um número específico de partículas de uma determinada posição com
-    // características definidas.
-    void Emit(Vector2 pos, int count, Color color, float speed, float size_min = 2.0f, float size_max = 5.0f) {
-        for (int i = 0; i < count; ++i) {
-            float angle = (float)GetRandomValue(0, 360) * DEG2RAD;
-            Vector2 vel = { sinf(angle) * speed, cosf(angle) * speed };
-            float life = (float)GetRandomValue(3, 8) / 10.0f;
-            float size = (float)GetRandomValue((int)(size_min * 10), (int)(size_max * 10)) / 10.0f;
-            particles.push_back({ pos, vel, life, color, size });
+    void Invalidate() { dirty = true; }
+
+    // Regrava a camada chamando 'paint' se necessário. Deve ser chamado fora
+    // do BeginDrawing, pois usa BeginTextureMode.
+    template <typename PaintFn>
+    void EnsureBaked(const Font& font, PaintFn paint) {
+        int w = GetScreenWidth();
+        int h = GetScreenHeight();
+        if (!dirty && target.id != 0 && font.texture.id == fontTexture && w == target.texture.width && h == target.texture.height) return;
+        if (target.id == 0 || w != target.texture.width || h != target.texture.height) {
+            Unload();
+            target = LoadRenderTexture(w, h);
         }
+        dirty = false;
+        fontTexture = font.texture.id;
+
+        // A camada guarda cor pré-multiplicada pelo alfa: assim as bordas
+        // suavizadas dos glifos não ficam com o alfa aplicado duas vezes
+        // quando a textura é desenhada por cima do fundo.
+        BeginTextureMode(target);
+        ClearBackground(BLANK);
+        rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+        BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+        paint();
+        EndBlendMode();
+        EndTextureMode();
     }
 
-    // Atualiza a posição e o tempo de vida de todas as partículas.
-    void Update(float delta) {
-        for (auto& p : particles) {
-            p.pos = MyVector2Add(p.pos, MyVector2Scale(p.vel, delta));
-            p.life -= delta;
-        }
-        //remove as partículas que expiraram.
-        particles.erase(std::remove_if(particles.begin(), particles.end(), [](const Particle& p) {
-            return p.life <= 0;
-        }), particles.end());
+    void Draw() const {
+        if (target.id == 0) return;
+        // Texturas de render ficam de cabeça para baixo; altura negativa inverte.
+        Rectangle src = { 0, 0, (float)target.texture.width, -(float)target.texture.height };
+        BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+        DrawTextureRec(target.texture, src, { 0, 0 }, WHITE);
+        EndBlendMode();
     }
 
-    // Desenha todas as partículas ativas na tela, com efeitos de fade-out e diminuição de tamanho.
-    void Draw() const {
-        for (const auto& p : particles) {
-            DrawCircleV(p.pos, p.size * (p.life / 0.8f), Fade(p.color, p.life / 0.8f));
-        }
+    void Unload() {
+        if (target.id != 0) UnloadRenderTexture(target);
+        target = {};
     }
+
+private:
+    RenderTexture2D target = {};
+    unsigned int fontTexture = 0;
+    bool dirty = true;
 };
 
 // =============================================================================
@@ -468,12 +3457,32 @@ public:
     std::string text;
     bool hovered = false;
     float fontSize;
+    // Layout do texto, refeito só quando texto, fonte ou tamanho mudam.
+    mutable TextLayout label;
+    Vector2 lastMouse = { -1, -1 };
+    bool layoutDirty = true;
 
     // Construtor: Inicializa a posição, tamanho, texto e tamanho da fonte do botão.
     Button(float x, float y, float w, float h, const char* t, float fs = 30) : rect{ x,y,w,h }, text(t), fontSize(fs) {}
 
+    // Define posição, tamanho e fonte do botão. Chamado quando a tela com o
+    // botão é aberta, não a cada frame; só marca o layout como alterado se
+    // algo realmente mudou.
+    void SetLayout(Rectangle r, float fs) {
+        if (r.x == rect.x && r.y == rect.y && r.width == rect.width && r.height == rect.height && fs == fontSize) return;
+        rect = r;
+        fontSize = fs;
+        layoutDirty = true;
+    }
+
+    // Atualiza o estado de "hover". O teste de colisão só é refeito quando o
+    // mouse se moveu ou o layout mudou.
     void Update() {
-        hovered = CheckCollisionPointRec(GetMousePosition(), rect);
+        Vector2 mouse = GetMousePosition();
+        if (!layoutDirty && mouse.x == lastMouse.x && mouse.y == lastMouse.y) return;
+        lastMouse = mouse;
+        layoutDirty = false;
+        hovered = CheckCollisionPointRec(mouse, rect);
     }
 
     // Desenha o botão na tela, com efeitos visuais para o estado de "hover".
@@ -482,43 +3491,140 @@ public:
         Color textColor = hovered ? UI_HIGHLIGHT_COLOR : UI_TEXT_COLOR;
         DrawRectangleRec(rect, bgColor);
         DrawRectangleLinesEx(rect, 2, UI_TEXT_COLOR);
-        Vector2 textSize = MeasureTextEx(font, text.c_str(), fontSize, 1);
+        label.Set(font, text.c_str(), fontSize, 1);
+        Vector2 textSize = label.Size();
         float textYOffset = (rect.height - textSize.y) / 2.0f;
-        DrawTextEx(font, text.c_str(), { rect.x + (rect.width - textSize.x) / 2.0f, rect.y + textYOffset }, fontSize, 1, textColor);
+        label.Draw({ rect.x + (rect.width - textSize.x) / 2.0f, rect.y + textYOffset }, textColor);
     }
 
     // Verifica se o botão foi clicado (mouse sobre ele e botão esquerdo pressionado).
     bool IsClicked() { return hovered && IsMouseButtonPressed(MOUSE_BUTTON_LEFT); }
 };
 
+// =============================================================================
+//                         AGENDADOR DE FRAMES OCIOSOS
+// =============================================================================
+
+// Decide a taxa de frames conforme há algo animando. Durante a partida (ou
+// com partículas, tremor de tela ou carregamento em andamento) usa a taxa
+// normal; em telas paradas cai para IDLE_FPS, economizando CPU/GPU e bateria,
+// e volta para a taxa normal assim que o jogador mexe no mouse ou teclado.
+class FrameScheduler {
+public:
+    explicit FrameScheduler(int activeRate) : activeFps(activeRate) {}
+
+    // Aplica a taxa normal. Chamado na criação da janela.
+    void Start() {
+        idle = false;
+        quietTime = 0.0f;
+        SetTargetFPS(activeFps); // 0 = sem limite (ou limitado pelo vsync)
+    }
+
+    // Chamado uma vez por frame, depois do desenho. Só troca a taxa do
+    // raylib quando o modo muda.
+    void EndFrame(bool animating, float delta) {
+        if (animating || HadUserInput()) quietTime = 0.0f;
+        else quietTime += delta;
+
+        bool shouldIdle = quietTime >= IDLE_GRACE_SECONDS && (activeFps == 0 || activeFps > IDLE_FPS);
+        if (shouldIdle == idle) return;
+        idle = shouldIdle;
+        SetTargetFPS(idle ? IDLE_FPS : activeFps);
+    }
+
+    bool IsIdle() const { return idle; }
+
+private:
+    int activeFps;
+    bool idle = false;
+    float quietTime = 0.0f;
+
+    // Qualquer movimento do mouse, clique, rolagem ou uma das teclas que o
+    // jogo usa conta como interação. As teclas são consultadas com IsKeyDown,
+    // que não consome nada: a fila de GetKeyPressed/GetCharPressed fica
+    // intacta para quem precisar dela (ex.: digitar texto).
+    static bool HadUserInput() {
+        static const int keys[] = { KEY_ENTER, KEY_P, KEY_F3, KEY_W, KEY_A, KEY_S, KEY_D,
+                                    KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT };
+        Vector2 mouseDelta = GetMouseDelta();
+        if (mouseDelta.x != 0.0f || mouseDelta.y != 0.0f || GetMouseWheelMove() != 0.0f) return true;
+        if (IsMouseButtonDown(MOUSE_BUTTON_LEFT) || IsMouseButtonDown(MOUSE_BUTTON_RIGHT)) return true;
+        for (int key : keys) {
+            if (IsKeyDown(key)) return true;
+        }
+        return false;
+    }
+};
+
 // =============================================================================
 //                          CLASSE PRINCIPAL DO JOGO (Game)
 // =============================================================================
 class Game {
 private:
     GameState state;
-    Player player;
-    std::vector<Wall*> walls;
-    std::vector<Coin> coins;
-    std::vector<PowerUp> powerups;
-    Objetivo* objetivo = nullptr;
-    int currentLevel;
-    const int maxLevels;
-    float totalGameTime;
-    const float initialGameTime = 180.0f;
-    int score;
+    // Todo o estado de gameplay fica no núcleo de simulação, que roda na
+    // thread de 'simThread'; Game apenas fornece a entrada do teclado e
+    // apresenta os retratos publicados por ela (som, partículas, desenho).
+    // O pool de threads é declarado antes para ser destruído depois da simulação.
+    JobSystem jobs;
+    Simulation sim;
+    LevelPrefetcher prefetcher;
+
+    // Passo fixo da simulação, em segundos, e fração do tick seguinte já
+    // decorrida desde o último retrato (fator de interpolação do desenho).
+    float tickDelta;
+    float renderAlpha;
 
     ParticleSystem particles;
+    BackgroundLayers background;
+    // Relógio da névoa e das estrelas. Fica parado enquanto o agendador está
+    // ocioso, para o fundo congelar em vez de animar aos trancos a IDLE_FPS.
+    double backgroundTime = 0.0;
     Camera2D camera;
     float screenShakeAmount;
+    Random shakeRng{ 0, RandomStream::CAMERA };
+    FrameScheduler frames;
     Font customFont;
     Texture2D lifeTexture;
 
+    // Gravação da partida em andamento, salva ao fim dela (ver SaveRecording).
+    Replay recording;
+    bool recordingActive = false;
+
+    // Thread de simulação. Declarada depois da simulação e da gravação, que
+    // ela usa, para ser encerrada antes delas na destruição.
+    SimulationThread simThread;
+    std::vector<SimEvent> frameEvents; // Eventos recebidos neste frame.
+    InputState frameInput; // Entrada lida neste frame (para o rastro do jogador).
+    int levelLoadError = 0; // Nível que falhou ao carregar (0 = nenhum), mostrado no menu.
+
+    // Parte fixa do menu, desenhada a partir de uma textura em cache.
+    CachedLayer menuLayer;
+
+    // Textos das telas, medidos e montados só quando mudam.
+    struct ScreenTexts {
+        TextLayout title, signature, loading, error;
+        TextLayout lives, score, time;
+        TextLayout paused, levelComplete, nextLevel;
+        TextLayout endTitle, finalScore, pressEnter;
+    } texts;
+
     // Botões para as telas de menu e pausa.
     Button startButton;
     Button resumeButton;
     Button exitButton;
 
+    // Pacote de recursos mapeado. Declarado antes do AssetLoader para continuar
+    // aberto enquanto as threads de carregamento ainda o leem.
+    AssetArchive pack;
+
+    // Carregamento assíncrono dos recursos e dados decodificados aguardando upload.
+    AssetLoader assets;
+    Font decodedFont = {};
+    Image fontAtlas = {};
+    Image lifeImage = {};
+    std::vector<Wave> decodedWaves;
+
     // Recursos de áudio (sons e música).
     Sound hitSound, victorySound, collectCoinSound, collectPowerupSound, spawnSound, clickSound, fieldEnable;
     Sound speedUpSound;
@@ -527,26 +3633,42 @@ private:
 
 public:
     // Construtor da classe Game. Inicializa a janela, áudio e botões.
-    Game() :
+    Game(float tickRate = DEFAULT_TICK_RATE, int targetFps = 60) :
         state(GameState::MENU),
-        maxLevels(3),
-        score(0),
+        tickDelta(1.0f / tickRate),
+        renderAlpha(1.0f),
         screenShakeAmount(0.0f),
+        frames(targetFps),
+        simThread(sim, tickDelta),
         startButton(0, 0, 250, 60, "INICIAR JOGO", 30),
         resumeButton(0, 0, 250, 60, "RESUMIR JOGO", 30),
         exitButton(0, 0, 250, 60, "SAIR DO JOGO", 30)
     {
         InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Labirinto das Sombras - by Tifany");
-        SetTargetFPS(60);
+        frames.Start();
         InitAudioDevice();
         LoadResources();
         camera.zoom = 1.0f;
+        simThread.Edit([&] { sim.jobs = &jobs; });
+        profiler.active.store(true, std::memory_order_relaxed);
+        // Os efeitos visuais variam a cada execução; a simulação tem a própria semente por partida.
+        uint64_t cosmeticSeed = (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+        particles.Seed(cosmeticSeed);
+        shakeRng.Seed(cosmeticSeed, RandomStream::CAMERA);
+        EnterState(GameState::MENU);
     }
 
     // Destrutor da classe Game. Libera todos os recursos alocados.
     ~Game() {
+        // Uma partida interrompida (janela fechada no meio) também é gravada.
+        simThread.Stop();
+        SaveRecording();
+        if (profiler.Frames() > 0) {
+            profiler.WriteCsv(PROFILE_CSV_PATH);
+            profiler.WriteJson(PROFILE_JSON_PATH);
+            TraceLog(LOG_INFO, "PROFILER: %d frames gravados em '%s' e '%s'.", profiler.Frames(), PROFILE_CSV_PATH, PROFILE_JSON_PATH);
+        }
         UnloadResources();
-        ClearLevel();
         CloseAudioDevice();
         CloseWindow();
     }
@@ -554,45 +3676,103 @@ public:
     // Loop principal do jogo.
     void Run() {
         while (!WindowShouldClose()) {
-            Update(GetFrameTime());
+            profiler.BeginFrame();
+            float delta = GetFrameTime();
+            if (!frames.IsIdle()) backgroundTime += delta;
+            Update(delta);
             Draw();
+            frames.EndFrame(IsAnimating(), delta);
         }
     }
 
 private:
     // Carrega todos os recursos (fontes, sons, música) necessários para o jogo.
+    // Fonte, textura e efeitos sonoros são decodificados em paralelo pelo
+    // AssetLoader; o menu aparece na hora (com a fonte padrão até a
+    // personalizada ficar pronta) e o jogo só inicia quando os recursos
+    // obrigatórios estiverem prontos. Se houver um "assets.pak", tudo é lido
+    // dele; senão, dos arquivos soltos em "assets/".
     void LoadResources() {
-        customFont = LoadFontEx("assets/font.ttf", 64, nullptr, 0);
-        if (customFont.texture.id == 0) {
-            customFont = GetFontDefault();
-            TraceLog(LOG_WARNING, "FONT: Falha ao carregar 'assets/font.ttf', usando a fonte padrão do próprio raylib.");
+        customFont = GetFontDefault();
+        lifeTexture = {};
+        particles.LoadSprite();
+        pack.Open(PACK_PATH);
+
+        assets.Add("font.ttf", false,
+            [this] { decodedFont = DecodeFont(pack, "font.ttf", 64, &fontAtlas); },
+            [this] {
+                if (fontAtlas.data == nullptr) {
+                    TraceLog(LOG_WARNING, "FONT: Falha ao carregar 'font.ttf', usando a fonte padrão do próprio raylib.");
+                    return;
+                }
+                decodedFont.texture = LoadTextureFromImage(fontAtlas);
+                UnloadImage(fontAtlas);
+                customFont = decodedFont;
+                TraceLog(LOG_INFO, "FONT: 'font.ttf' foi encontrada.");
+            });
+
+        assets.Add("life.png", true,
+            [this] { lifeImage = LoadImageAsset(pack, "life.png"); },
+            [this] {
+                lifeTexture = LoadTextureFromImage(lifeImage);
+                UnloadImage(lifeImage);
+            });
+
+        struct SoundAsset { Sound* sound; const char* name; };
+        const SoundAsset sounds[] = {
+            { &hitSound, "hit.mp3" },
+            { &victorySound, "victory.mp3" },
+            { &fieldEnable, "fieldEnable.mp3" },
+            { &collectCoinSound, "collect_coin.mp3" },
+            { &collectPowerupSound, "collect_powerup.mp3" },
+            { &spawnSound, "spawn.mp3" },
+            { &clickSound, "click.mp3" },
+            { &speedUpSound, "speed_up.mp3" },
+            { &finalVictorySound, "endVictory.mp3" },
+        };
+        decodedWaves.resize(sizeof(sounds) / sizeof(sounds[0]));
+        for (size_t i = 0; i < decodedWaves.size(); i++) {
+            Sound* sound = sounds[i].sound;
+            const char* name = sounds[i].name;
+            Wave* wave = &decodedWaves[i];
+            *sound = {};
+            assets.Add(name, true,
+                [this, wave, name] { *wave = LoadWaveAsset(pack, name); },
+                [this, wave, sound] {
+                    *sound = LoadSoundFromWave(*wave);
+                    if (!pack.Owns(wave->data)) UnloadWave(*wave);
+                });
+        }
+        assets.Start();
+
+        // A música é transmitida em partes durante o jogo, então abrir o stream
+        // é rápido. Do pacote, ela é lida direto da memória mapeada. Os buffers
+        // maiores que o padrão aguentam os frames espaçados das telas ociosas.
+        SetAudioStreamBufferSizeDefault(MUSIC_BUFFER_FRAMES);
+        const unsigned char* musicData;
+        size_t musicSize;
+        if (pack.IsOpen() && pack.Find(MUSIC_ASSET, &musicData, &musicSize)) {
+            backgroundMusic = LoadMusicStreamFromMemory(GetFileExtension(MUSIC_ASSET), musicData, (int)musicSize);
         } else {
-            TraceLog(LOG_INFO, "FONT: 'assets/font.ttf' foi encontrada.");
+            backgroundMusic = LoadMusicStream(AssetPath(MUSIC_ASSET).c_str());
         }
-
-        lifeTexture = LoadTexture("assets/life.png");
-
-        hitSound = LoadSound("assets/hit.mp3");
-        victorySound = LoadSound("assets/victory.mp3");
-        fieldEnable = LoadSound("assets/fieldEnable.mp3");
-        collectCoinSound = LoadSound("assets/collect_coin.mp3");
-        collectPowerupSound = LoadSound("assets/collect_powerup.mp3");
-        spawnSound = LoadSound("assets/spawn.mp3");
-        clickSound = LoadSound("assets/click.mp3");
-        speedUpSound = LoadSound("assets/speed_up.mp3");
-        finalVictorySound = LoadSound("assets/endVictory.mp3");
-        backgroundMusic = LoadMusicStream("assets/music.mp3");
         PlayMusicStream(backgroundMusic);
     }
 
     // Descarrega todos os recursos carregados para liberar a memória.
     void UnloadResources() {
+        // Termina os carregamentos em andamento para que tudo seja descarregado abaixo.
+        assets.Finish();
+
         if (customFont.texture.id != 0 && customFont.recs != GetFontDefault().recs) {
              UnloadFont(customFont);
              TraceLog(LOG_INFO, "FONT: Fonte personalizada descarregada.");
         }
 
         UnloadTexture(lifeTexture);
+        particles.UnloadSprite();
+        background.Unload();
+        menuLayer.Unload();
 
         UnloadSound(hitSound);
         UnloadSound(victorySound);
@@ -606,122 +3786,108 @@ private:
         UnloadMusicStream(backgroundMusic);
     }
 
-    // Limpa todas as entidades do nível atual para preparar um novo nível.
-    void ClearLevel() {
-        for (auto wall : walls) delete wall;
-        walls.clear();
-        coins.clear();
-        powerups.clear();
-        delete objetivo;
-        objetivo = nullptr;
+    // Indica se algo na tela muda sozinho neste momento, sem interação do jogador.
+    // A névoa e as estrelas não contam: nas telas paradas elas animam até o
+    // agendador ficar ocioso e então congelam (ver backgroundTime).
+    bool IsAnimating() const {
+        if (state == GameState::PLAYING) return true;
+        return particles.Count() > 0 || screenShakeAmount > 0 || !assets.RequiredReady();
     }
 
-    // Carrega a configuração específica de paredes, moedas e power-ups para um dado nível.
-    void LoadLevel(int level) {
-        ClearLevel();
-        player.Reset();
+    // Troca o estado do jogo. As telas com botões calculam o layout aqui, uma
+    // vez por entrada, em vez de a cada frame.
+    void EnterState(GameState next) {
+        state = next;
+        simThread.SetRunning(next == GameState::PLAYING);
+        if (next == GameState::MENU) LayoutMenu();
+        else if (next == GameState::PAUSED) LayoutPauseMenu();
+    }
 
-        coins.clear();
-        switch(level) {
-            case 1:
-                coins.emplace_back(SCREEN_WIDTH * 0.25f, SCREEN_HEIGHT * 0.1f);
-                coins.emplace_back(SCREEN_WIDTH - SCREEN_WIDTH * 0.25f, SCREEN_HEIGHT * 0.08f);
-                coins.emplace_back(SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f);
-                coins.emplace_back(SCREEN_WIDTH * 0.1f, SCREEN_HEIGHT - SCREEN_HEIGHT * 0.1f);
-                coins.emplace_back(SCREEN_WIDTH - SCREEN_WIDTH * 0.1f, SCREEN_HEIGHT - SCREEN_HEIGHT * 0.15f);
-                break;
-            case 2:
-                coins.emplace_back(SCREEN_WIDTH * 0.15f, SCREEN_HEIGHT * 0.4f);
-                coins.emplace_back(SCREEN_WIDTH * 0.475f, SCREEN_HEIGHT * 0.15f);
-                coins.emplace_back(SCREEN_WIDTH * 0.6f, SCREEN_HEIGHT * 0.6f);
-                coins.emplace_back(SCREEN_WIDTH - SCREEN_WIDTH * 0.15f, SCREEN_HEIGHT * 0.3f);
-                coins.emplace_back(SCREEN_WIDTH * 0.05f, SCREEN_HEIGHT * 0.05f);
-                coins.emplace_back(SCREEN_WIDTH - SCREEN_WIDTH * 0.05f, SCREEN_HEIGHT - SCREEN_HEIGHT * 0.05f);
-                coins.emplace_back(SCREEN_WIDTH / 2.0f + 50, SCREEN_HEIGHT / 2.0f + 50);
-                break;
-            case 3:
-                coins.emplace_back(SCREEN_WIDTH * 0.1f, SCREEN_HEIGHT * 0.45f);
-                coins.emplace_back(SCREEN_WIDTH * 0.5f, SCREEN_HEIGHT * 0.05f);
-                coins.emplace_back(SCREEN_WIDTH - SCREEN_WIDTH * 0.2f, SCREEN_HEIGHT * 0.25f);
-                coins.emplace_back(SCREEN_WIDTH * 0.7f, SCREEN_HEIGHT * 0.7f);
-                coins.emplace_back(SCREEN_WIDTH * 0.2f, SCREEN_HEIGHT * 0.6f);
-                coins.emplace_back(SCREEN_WIDTH / 2.0f + 100, SCREEN_HEIGHT * 0.3f);
-                coins.emplace_back(SCREEN_WIDTH * 0.05f, SCREEN_HEIGHT - SCREEN_HEIGHT * 0.2f);
-                coins.emplace_back(SCREEN_WIDTH - SCREEN_WIDTH * 0.05f, SCREEN_HEIGHT * 0.1f);
-                coins.emplace_back(SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT * 0.8f); // arrumar posição da moeda
-                coins.emplace_back(SCREEN_WIDTH * 0.15f, SCREEN_HEIGHT * 0.15f);
-                break;
-        }
+    // Empilha dois botões centralizados na tela, deslocados 'yOffset' para baixo do centro.
+    static void LayoutButtonPair(Button& first, Button& second, float spacing, float yOffset) {
+        const float buttonWidth = 300;
+        const float buttonHeight = 75;
+        const float buttonFontSize = 40;
+        float x = (SCREEN_WIDTH - buttonWidth) / 2.0f;
+        float startY = (SCREEN_HEIGHT - (buttonHeight * 2 + spacing)) / 2.0f + yOffset;
+        first.SetLayout({ x, startY, buttonWidth, buttonHeight }, buttonFontSize);
+        second.SetLayout({ x, startY + buttonHeight + spacing, buttonWidth, buttonHeight }, buttonFontSize);
+    }
 
-        objetivo = new Objetivo((float)SCREEN_WIDTH - 80, (float)SCREEN_HEIGHT / 2.0f - 20);
-        objetivo->enabled = false;
+    void LayoutMenu() {
+        LayoutButtonPair(startButton, exitButton, 35, SCREEN_HEIGHT * 0.08f);
+        menuLayer.Invalidate();
+    }
 
-        powerups.emplace_back(PowerUpType::LIFE);
-        powerups.emplace_back(PowerUpType::SHIELD);
-        if (level > 1) {
-            powerups.emplace_back(PowerUpType::SPEED);
+    void LayoutPauseMenu() {
+        LayoutButtonPair(resumeButton, exitButton, 30, 40.0f);
+    }
+
+    // Inicia um novo jogo, redefinindo o estado e carregando o primeiro nível.
+    // Cada partida recebe uma semente nova e é gravada para replay.
+    void StartGame() {
+        uint32_t seed = (uint32_t)std::chrono::steady_clock::now().time_since_epoch().count();
+        bool loaded = false;
+        simThread.Edit([&] {
+            loaded = sim.StartGame(seed);
+            if (!loaded) return;
+            recording.Begin(seed, tickDelta);
+            simThread.recorder = &recording;
+        });
+        if (!loaded) {
+            FailLevelLoad(1);
+            return;
         }
+        levelLoadError = 0;
+        recordingActive = true;
+        EnterState(GameState::PLAYING);
+    }
 
-        switch (level) { //posição das paredes é setada manualmente.
-            case 1:
-                walls.push_back(new Wall(SCREEN_WIDTH * 0.15f, 0, 20, SCREEN_HEIGHT * 0.25f, 0, 70));
-                walls.push_back(new Wall(SCREEN_WIDTH * 0.3f, SCREEN_HEIGHT - SCREEN_HEIGHT * 0.25f, 20, SCREEN_HEIGHT * 0.25f, 0, -90));
-                walls.push_back(new Wall(SCREEN_WIDTH * 0.45f, 0, 20, SCREEN_HEIGHT * 0.3f, 0, 100));
-                walls.push_back(new Wall(SCREEN_WIDTH * 0.6f, SCREEN_HEIGHT - SCREEN_HEIGHT * 0.35f, 20, SCREEN_HEIGHT * 0.35f, 0, -80));
-                walls.push_back(new Wall(SCREEN_WIDTH * 0.2f, SCREEN_HEIGHT * 0.2f, 100, 20, 50, 0));
-                walls.push_back(new Wall(SCREEN_WIDTH - SCREEN_WIDTH * 0.3f, SCREEN_HEIGHT * 0.4f, 100, 20, -50, 0));
-                break;
-            case 2:
-                walls.push_back(new Wall(SCREEN_WIDTH * 0.1f, 0, 20, SCREEN_HEIGHT * 0.3f, 0, 100));
-                walls.push_back(new Wall(SCREEN_WIDTH * 0.25f, SCREEN_HEIGHT - SCREEN_HEIGHT * 0.3f, 20, SCREEN_HEIGHT * 0.3f, 0, -120));
-                walls.push_back(new ParedeEspecial(SCREEN_WIDTH * 0.4f, SCREEN_HEIGHT * 0.05f, 20, SCREEN_HEIGHT * 0.4f, 0, 150));
-                walls.push_back(new ParedeEspecial(SCREEN_WIDTH * 0.55f, SCREEN_HEIGHT - SCREEN_HEIGHT * 0.45f, 20, SCREEN_HEIGHT * 0.4f, 0, -140));
-                walls.push_back(new Wall(SCREEN_WIDTH * 0.2f, SCREEN_HEIGHT * 0.25f, 150, 20, 0, 0));
-                walls.push_back(new Wall(SCREEN_WIDTH - SCREEN_WIDTH * 0.35f, SCREEN_HEIGHT * 0.35f, 150, 20, 0, 0));
-                walls.push_back(new Wall(SCREEN_WIDTH / 2.0f - 100, SCREEN_HEIGHT * 0.1f, 200, 20, 0, 0));
-                walls.push_back(new Wall(SCREEN_WIDTH / 2.0f - 100, SCREEN_HEIGHT - SCREEN_HEIGHT * 0.12f, 200, 20, 0, 0));
-                break;
-            case 3:
-                walls.push_back(new Wall(SCREEN_WIDTH * 0.1f, SCREEN_HEIGHT * 0.05f, 20, SCREEN_HEIGHT * 0.35f, 0, 180));
-                walls.push_back(new Wall(SCREEN_WIDTH * 0.25f, SCREEN_HEIGHT - SCREEN_HEIGHT * 0.4f, 20, SCREEN_HEIGHT * 0.35f, 0, -200));
-                walls.push_back(new ParedeEspecial(SCREEN_WIDTH * 0.4f, 0, 20, SCREEN_HEIGHT * 0.5f, 0, 220));
-                walls.push_back(new ParedeEspecial(SCREEN_WIDTH * 0.55f, SCREEN_HEIGHT - SCREEN_HEIGHT * 0.55f, 20, SCREEN_HEIGHT * 0.5f, 0, -210));
-                walls.push_back(new Wall(SCREEN_WIDTH * 0.2f, SCREEN_HEIGHT * 0.2f, 200, 20, 0, 0));
-                walls.push_back(new Wall(SCREEN_WIDTH - SCREEN_WIDTH * 0.4f, SCREEN_HEIGHT * 0.4f, 200, 20, 0, 0));
-                walls.push_back(new Wall(SCREEN_WIDTH / 3.0f, 0, 20, 100, 0, 0));
-                walls.push_back(new Wall(SCREEN_WIDTH / 3.0f, SCREEN_HEIGHT - 100, 20, 100, 0, 0));
-                walls.push_back(new Wall(20, SCREEN_HEIGHT / 3.0f, 80, 20, 0, 0));
-                walls.push_back(new Wall(SCREEN_WIDTH - 100, SCREEN_HEIGHT / 3.0f, 80, 20, 0, 0));
-                walls.push_back(new Wall(SCREEN_WIDTH / 2.0f - 150, SCREEN_HEIGHT / 2.0f - 10, 300, 20, 0, 0));
-                walls.push_back(new ParedeEspecial(SCREEN_WIDTH / 2.0f - 10, 50, 20, 150, 0, 100));
-                walls.push_back(new ParedeEspecial(SCREEN_WIDTH / 2.0f - 10, SCREEN_HEIGHT - 200, 20, 150, 0, -100));
-                break;
+    // Um nível não pôde ser carregado: abandona a partida (sem gravar o
+    // replay, que não teria como ser reproduzido) e volta ao menu, que mostra o erro.
+    void FailLevelLoad(int level) {
+        TraceLog(LOG_ERROR, "LEVEL: não foi possível carregar o nível %d de '%s'.", level, LevelsDir().c_str());
+        if (recordingActive) {
+            recordingActive = false;
+            simThread.Edit([&] { simThread.recorder = nullptr; });
         }
+        levelLoadError = level;
+        EnterState(GameState::MENU);
     }
 
-    // Inicia um novo jogo, redefinindo o estado e carregando o primeiro nível.
-    void StartGame() {
-        state = GameState::PLAYING;
-        currentLevel = 1;
-        totalGameTime = initialGameTime;
-        score = 0;
-        LoadLevel(currentLevel);
+    // Grava em disco o replay da partida atual com o estado final dela.
+    void SaveRecording() {
+        if (!recordingActive) return;
+        recordingActive = false;
+        simThread.Edit([&] {
+            simThread.recorder = nullptr;
+            recording.outcome = ReplayOutcome::From(sim);
+        });
+        if (recording.Save(LAST_REPLAY_PATH)) {
+            TraceLog(LOG_INFO, "REPLAY: partida gravada em '%s' (%d ticks).", LAST_REPLAY_PATH, (int)recording.inputs.size());
+        } else {
+            TraceLog(LOG_WARNING, "REPLAY: não foi possível gravar '%s'.", LAST_REPLAY_PATH);
+        }
     }
 
     // Atualiza a lógica do jogo a cada frame, baseando-se no estado atual.
     void Update(float delta) {
+        ProfileScope scope(ProfilePhase::UPDATE);
+        if (IsKeyPressed(KEY_F3)) profiler.overlayVisible = !profiler.overlayVisible;
+        assets.Poll();
         UpdateMusicStream(backgroundMusic);
+        if (IsWindowResized()) EnterState(state);
 
         // Lógica para o efeito de tela tremendo quando há impacto.
         if (screenShakeAmount > 0) screenShakeAmount -= 5.0f * delta;
-        camera.offset.x = GetRandomValue(-1, 1) * screenShakeAmount * 10;
-        camera.offset.y = GetRandomValue(-1, 1) * screenShakeAmount * 10;
+        camera.offset.x = shakeRng.Int(-1, 1) * screenShakeAmount * 10;
+        camera.offset.y = shakeRng.Int(-1, 1) * screenShakeAmount * 10;
 
         // Gerencia a lógica com base no estado atual do jogo.
         switch (state) {
             case GameState::MENU:
                 startButton.Update();
-                if (startButton.IsClicked()) {
+                if (startButton.IsClicked() && assets.RequiredReady()) {
                     PlaySound(clickSound);
                     StartGame();
                 }
@@ -732,13 +3898,18 @@ private:
                 }
                 break;
             case GameState::PLAYING:
-                UpdatePlaying(delta);
+                if (IsKeyPressed(KEY_P)) {
+                    EnterState(GameState::PAUSED);
+                    break;
+                }
+                frameInput = ReadKeyboardInput();
+                simThread.SetInput(frameInput);
                 break;
             case GameState::PAUSED:
                 resumeButton.Update();
                 if (resumeButton.IsClicked()) {
                     PlaySound(clickSound);
-                    state = GameState::PLAYING;
+                    EnterState(GameState::PLAYING);
                 }
                 exitButton.Update();
                 if (exitButton.IsClicked()) {
@@ -751,9 +3922,13 @@ private:
                 if (!IsSoundPlaying(victorySound)) PlaySound(victorySound);
                 if (IsKeyPressed(KEY_ENTER)) {
                     StopSound(victorySound);
-                    state = GameState::PLAYING;
-                    currentLevel++;
-                    LoadLevel(currentLevel);
+                    // O nível foi pedido ao entrar na transição; aqui só troca os dados.
+                    int nextLevel = simThread.snapshots.Front().currentLevel + 1;
+                    std::unique_ptr<LevelData> next = prefetcher.Take(nextLevel);
+                    bool loaded = false;
+                    simThread.Edit([&] { loaded = sim.NextLevel(next.get()); });
+                    if (loaded) EnterState(GameState::PLAYING);
+                    else FailLevelLoad(nextLevel);
                 }
                 break;
             case GameState::VICTORY:
@@ -761,122 +3936,107 @@ private:
                 if (!IsSoundPlaying(finalVictorySound)) PlaySound(finalVictorySound);
                 if (IsKeyPressed(KEY_ENTER)) {
                     StopSound(finalVictorySound); // Para o som ao voltar para o menu
-                    state = GameState::MENU;
+                    EnterState(GameState::MENU);
                 }
                 break;
             case GameState::GAMEOVER:
                 if (!IsSoundPlaying(hitSound)) PlaySound(hitSound);
                 if (IsKeyPressed(KEY_ENTER)) {
                     StopSound(hitSound); // Para o som ao voltar para o menu
-                    state = GameState::MENU;
+                    EnterState(GameState::MENU);
                 }
                 break;
         }
-        particles.Update(delta);
-        if (objetivo) objetivo->Update(delta);
+        SyncSimulation();
+        ProfileScope particleScope(ProfilePhase::PARTICLES);
+        particles.Update(delta, &jobs);
     }
 
-    // Contém a lógica de jogo que é executada quando o estado é PLAYING.
-    void UpdatePlaying(float delta) {
-        if (IsKeyPressed(KEY_P)) state = GameState::PAUSED;
-
-        totalGameTime -= delta;
-
-        // Verifica se o tempo acabou.
-        if (totalGameTime <= 0) {
-            state = GameState::GAMEOVER;
-            PlaySound(hitSound);
-            return;
-        }
-
-        player.Update(delta);
-
-        // Emite partículas de rastro do jogador quando ele se move.
-        if (IsKeyDown(KEY_W) || IsKeyDown(KEY_S) || IsKeyDown(KEY_A) || IsKeyDown(KEY_D) ||
-            IsKeyDown(KEY_UP) || IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_RIGHT)) {
-            particles.Emit({ player.rect.x + player.rect.width / 2, player.rect.y + player.rect.height / 2 }, 1, BACKGROUND_DEEPEST_DARK, 50, 1.0f, 3.0f);
-        }
-
-        // Contador de moedas coletadas.
-        int collectedCoins = 0;
-        for (auto& p : powerups) {
-            bool was_inactive = !p.active;
-            p.Update(delta);
-            if (was_inactive && p.active) PlaySound(spawnSound);
-            if (p.TryCollect(player)) {
-                PlaySound(collectPowerupSound);
-                Color particleColor = p.type == PowerUpType::LIFE ? LIFE_POWERUP_COLOR : (p.type == PowerUpType::SHIELD ? SHIELD_POWERUP_COLOR : SPEED_POWERUP_COLOR);
-                particles.Emit({ p.rect.x + p.rect.width / 2, p.rect.y + p.rect.height / 2 }, 20, particleColor, 100, 3.0f, 6.0f);
-                if (p.type == PowerUpType::SPEED) PlaySound(speedUpSound);
-            }
-        }
-
-        for (auto& coin : coins) {
-            if (coin.TryCollect(player)) {
-                PlaySound(collectCoinSound);
-                score += 100;
-                particles.Emit({ coin.rect.x + coin.rect.width / 2, coin.rect.y + coin.rect.height / 2 }, 15, COIN_COLOR, 80, 2.0f, 4.0f);
-            }
-            if (!coin.active) collectedCoins++;
+    // Recebe da thread de simulação os eventos e o retrato mais novo e troca
+    // de tela quando a partida muda de status.
+    void SyncSimulation() {
+        simThread.DrainEvents(frameEvents);
+        HandleSimEvents(frameEvents);
+
+        const SimSnapshot& view = simThread.snapshots.Acquire();
+        if (state != GameState::PLAYING) return;
+        float sinceTick = std::chrono::duration<float>(std::chrono::steady_clock::now() - view.time).count();
+        renderAlpha = std::clamp(sinceTick / tickDelta, 0.0f, 1.0f);
+
+        // Emite partículas de rastro do jogador quando ele se move. Uma por
+        // frame desenhado, e não por tick, para que a densidade do rastro não
+        // mude com a taxa de ticks.
+        if (frameInput.Moving() && view.status == SimStatus::RUNNING) {
+            particles.Emit(Simulation::Center(view.player.rect), 1, BACKGROUND_DEEPEST_DARK, 50, 1.0f, 3.0f);
         }
+        frameInput = {};
 
-        // Habilita o objetivo se todas as moedas foram coletadas.
-        if (objetivo && !objetivo->enabled && collectedCoins == coins.size()) {
-            objetivo->Enable();
-            particles.Emit({ objetivo->rect.x + objetivo->rect.width / 2, objetivo->rect.y + objetivo->rect.height / 2 }, 50, GOAL_COLOR, 200, 5.0f, 10.0f);
-            PlaySound(fieldEnable);
+        switch (view.status) {
+            case SimStatus::RUNNING: break;
+            case SimStatus::LEVEL_COMPLETE:
+                EnterState(GameState::LEVEL_TRANSITION);
+                prefetcher.Request(view.currentLevel + 1);
+                break;
+            // O som de vitória final será tocado no Update()
+            case SimStatus::VICTORY:
+                EnterState(GameState::VICTORY);
+                SaveRecording();
+                break;
+            case SimStatus::GAMEOVER:
+                EnterState(GameState::GAMEOVER);
+                SaveRecording();
+                break;
         }
+    }
 
-        // Atualiza e verifica colisões com as paredes.
-        for (auto wall : walls) {
-            wall->Update(delta);
-            if (CheckCollisionRecs(player.rect, wall->rect)) {
-                if (player.invincibilityTimer <= 0 && player.shieldTimer <= 0) {
-                    player.TakeDamage();
+    // Traduz eventos da simulação em sons, partículas e tremor de tela.
+    void HandleSimEvents(const std::vector<SimEvent>& events) {
+        for (const SimEvent& e : events) {
+            switch (e.type) {
+                case SimEventType::POWERUP_SPAWNED:
+                    PlaySound(spawnSound);
+                    break;
+                case SimEventType::POWERUP_COLLECTED: {
+                    PlaySound(collectPowerupSound);
+                    Color particleColor = e.powerUp == PowerUpType::LIFE ? LIFE_POWERUP_COLOR : (e.powerUp == PowerUpType::SHIELD ? SHIELD_POWERUP_COLOR : SPEED_POWERUP_COLOR);
+                    particles.Emit(e.pos, 20, particleColor, 100, 3.0f, 6.0f);
+                    if (e.powerUp == PowerUpType::SPEED) PlaySound(speedUpSound);
+                    break;
+                }
+                case SimEventType::COIN_COLLECTED:
+                    PlaySound(collectCoinSound);
+                    particles.Emit(e.pos, 15, COIN_COLOR, 80, 2.0f, 4.0f);
+                    break;
+                case SimEventType::GOAL_ENABLED:
+                    particles.Emit(e.pos, 50, GOAL_COLOR, 200, 5.0f, 10.0f);
+                    PlaySound(fieldEnable);
+                    break;
+                case SimEventType::PLAYER_HIT:
                     PlaySound(hitSound);
-                    particles.Emit({ player.rect.x + player.rect.width / 2, player.rect.y + player.rect.height / 2 }, 30, UI_WARNING_COLOR, 120, 4.0f, 8.0f);
+                    particles.Emit(e.pos, 30, UI_WARNING_COLOR, 120, 4.0f, 8.0f);
                     screenShakeAmount = 1.0f;
-                }
-            }
-        }
-
-        // Verifica a condição de Game Over (vidas esgotadas).
-        if (player.lives <= 0) state = GameState::GAMEOVER;
-        // Verifica se o jogador alcançou o objetivo final do nível, APENAS SE ESTIVER HABILITADO O CAMPO!
-        if (objetivo && objetivo->enabled && CheckCollisionRecs(player.rect, objetivo->rect)) {
-            score += 5000;
-            if (currentLevel < maxLevels) {
-                state = GameState::LEVEL_TRANSITION;
-            } else {
-                state = GameState::VICTORY;
-                // O som de vitória final será tocado no Update()
+                    break;
+                case SimEventType::TIME_OVER:
+                    PlaySound(hitSound);
+                    break;
             }
         }
     }
 
     // Função de desenho principal que renderiza todos os elementos na tela.
     void Draw() {
+        ProfileScope scope(ProfilePhase::DRAW);
+        // As camadas de fundo são (re)geradas fora do BeginDrawing, pois usam texturas de render.
+        background.EnsureBaked();
+        if (state == GameState::MENU) menuLayer.EnsureBaked(customFont, [this] { PaintMenuStatic(); });
+
         BeginDrawing();
         ClearBackground(BACKGROUND_DEEPEST_DARK);
 
         BeginMode2D(camera);
 
-        // Efeito de fundo de névoa.
-        float fogSpeed = 20.0f;
-        float timeOffset = fmod(GetTime() * fogSpeed, SCREEN_HEIGHT * 2);
-
-        for(int i = 0; i < 2; i++) {
-            float currentY = (float)SCREEN_HEIGHT - timeOffset + (i * SCREEN_HEIGHT);
-            DrawRectangleGradientV(0, (int)currentY, SCREEN_WIDTH, SCREEN_HEIGHT, BACKGROUND_FOG_START, BACKGROUND_FOG_END);
-        }
-
-        for (int i = 0; i < 200; i++) {
-            float randX = (float)GetRandomValue(0, SCREEN_WIDTH);
-            float randY = (float)GetRandomValue(0, SCREEN_HEIGHT);
-            float randAlpha = (float)GetRandomValue(10, 80) / 255.0f;
-            float randSize = (float)GetRandomValue(1, 2);
-            DrawCircleV({randX, randY}, randSize, Fade(UI_TEXT_COLOR, randAlpha));
-        }
+        // Névoa e estrelas pré-renderizadas.
+        background.Draw(backgroundTime);
 
         // Desenha elementos específicos com base no estado atual do jogo.
         switch (state) {
@@ -897,112 +4057,98 @@ private:
         }
 
         EndMode2D();
+        profiler.DrawOverlay();
         EndDrawing();
     }
 
-    // Desenha a tela inicial do menu.
-    void DrawMenu() {
+    // Desenha a parte fixa do menu (título e assinatura) na camada em cache.
+    void PaintMenuStatic() {
         const char* gameTitle = "LABIRINTO DAS SOMBRAS";
         float titleFontSize = 90;
-        Vector2 titleSize = MeasureTextEx(customFont, gameTitle, titleFontSize, 2);
+        texts.title.Set(customFont, gameTitle, titleFontSize, 2);
+        Vector2 titleSize = texts.title.Size();
         float titleYPosition = SCREEN_HEIGHT * 0.25f - titleSize.y / 2.0f;
-        DrawTextEx(customFont, gameTitle, { (SCREEN_WIDTH - titleSize.x) / 2.0f, titleYPosition }, titleFontSize, 2, UI_ACCENT_COLOR);
-
-        float buttonWidth = 300;
-        float buttonHeight = 75;
-        float buttonFontSize = 40;
-        float buttonSpacing = 35;
-        float buttonOverallYOffset = SCREEN_HEIGHT * 0.08f;
-
-        float totalButtonsHeight = (buttonHeight * 2) + buttonSpacing;
-        float startY = (SCREEN_HEIGHT - totalButtonsHeight) / 2.0f + buttonOverallYOffset;
-
-        startButton.rect.x = (SCREEN_WIDTH - buttonWidth) / 2.0f;
-        startButton.rect.y = startY;
-        startButton.rect.width = buttonWidth;
-        startButton.rect.height = buttonHeight;
-        startButton.fontSize = buttonFontSize;
-        startButton.Draw(customFont);
-
-        exitButton.rect.x = (SCREEN_WIDTH - buttonWidth) / 2.0f;
-        exitButton.rect.y = startY + buttonHeight + buttonSpacing;
-        exitButton.rect.width = buttonWidth;
-        exitButton.rect.height = buttonHeight;
-        exitButton.fontSize = buttonFontSize;
-        exitButton.Draw(customFont);
+        texts.title.Draw({ (SCREEN_WIDTH - titleSize.x) / 2.0f, titleYPosition }, UI_ACCENT_COLOR);
 
         const char* signature = "POR TIFANY LUIZA";
         float signatureFontSize = 28;
-        Vector2 signatureSize = MeasureTextEx(customFont, signature, signatureFontSize, 1);
-        DrawTextEx(customFont, signature, { (SCREEN_WIDTH - signatureSize.x) / 2.0f, SCREEN_HEIGHT - 45 }, signatureFontSize, 1, UI_TEXT_COLOR);
+        texts.signature.Set(customFont, signature, signatureFontSize, 1);
+        Vector2 signatureSize = texts.signature.Size();
+        texts.signature.Draw({ (SCREEN_WIDTH - signatureSize.x) / 2.0f, SCREEN_HEIGHT - 45 }, UI_TEXT_COLOR);
+    }
+
+    // Desenha a tela inicial do menu. O layout dos botões vem de LayoutMenu().
+    void DrawMenu() {
+        menuLayer.Draw();
+        startButton.Draw(customFont);
+        exitButton.Draw(customFont);
+
+        // Enquanto os recursos obrigatórios carregam, o botão de iniciar não responde.
+        if (!assets.RequiredReady()) {
+            texts.loading.SetFormatted(customFont, "CARREGANDO... %d%%", (int)(assets.Progress() * 100), 24, 1);
+            Vector2 loadingSize = texts.loading.Size();
+            texts.loading.Draw({ (SCREEN_WIDTH - loadingSize.x) / 2.0f, startButton.rect.y - loadingSize.y - 20 }, UI_TEXT_COLOR);
+        } else if (levelLoadError > 0) {
+            texts.error.SetFormatted(customFont, "ERRO AO CARREGAR O NIVEL %d", levelLoadError, 24, 1);
+            Vector2 errorSize = texts.error.Size();
+            texts.error.Draw({ (SCREEN_WIDTH - errorSize.x) / 2.0f, startButton.rect.y - errorSize.y - 20 }, UI_WARNING_COLOR);
+        }
     }
 
     // Desenha todos os elementos do jogo durante a partida (jogador, paredes, moedas, etc.).
     void DrawPlaying() {
-        if (objetivo) objetivo->Draw();
-        for (const auto& p : powerups) p.Draw();
-        for (const auto& coin : coins) coin.Draw();
-        for (const auto wall : walls) wall->Draw();
-        particles.Draw();
-        player.Draw();
+        {
+            ProfileScope scope(ProfilePhase::DRAW_ENTITIES);
+            const SimSnapshot& view = simThread.snapshots.Front();
+            if (view.hasObjetivo) view.objetivo.Draw();
+            DrawPowerUps(view.world);
+            DrawCoins(view.world);
+            for (size_t i = 0; i < view.walls.Size(); i++) view.walls.DrawAt(i, LerpRect(view.walls.PrevRect(i), view.walls.Rect(i), renderAlpha));
+            particles.Draw();
+            view.player.DrawAt(LerpRect(view.player.prevRect, view.player.rect, renderAlpha));
+        }
         DrawHUD();
     }
 
     // Desenha a HUD do jogo, incluindo vidas, pontuação e tempo.
     void DrawHUD() {
-        DrawTextEx(customFont, "VIDAS:", { 30, 20 }, 30, 1, UI_TEXT_COLOR);
-        for (int i = 0; i < player.lives; i++) {
+        ProfileScope scope(ProfilePhase::DRAW_HUD);
+        const SimSnapshot& view = simThread.snapshots.Front();
+        texts.lives.Set(customFont, "VIDAS:", 30, 1);
+        texts.lives.Draw({ 30, 20 }, UI_TEXT_COLOR);
+        for (int i = 0; i < view.player.lives; i++) {
             DrawTextureEx(lifeTexture, { 150 + i * 30.0f, 25.0f }, 0.0f, 0.07f, WHITE);
         }
 
-        std::string scoreText = TextFormat("PONTOS: %06d", score);
         float scoreFontSize = 30;
-        Vector2 scoreTextSize = MeasureTextEx(customFont, scoreText.c_str(), scoreFontSize, 1);
-        DrawTextEx(customFont, scoreText.c_str(), { SCREEN_WIDTH - scoreTextSize.x - 30, 20 }, scoreFontSize, 1, UI_TEXT_COLOR);
+        texts.score.SetFormatted(customFont, "PONTOS: %06d", view.score, scoreFontSize, 1);
+        Vector2 scoreTextSize = texts.score.Size();
+        texts.score.Draw({ SCREEN_WIDTH - scoreTextSize.x - 30, 20 }, UI_TEXT_COLOR);
 
-        std::string timeText = TextFormat("TEMPO: %03d", (int)totalGameTime);
         float timeFontSize = 30;
-        Vector2 timeTextSize = MeasureTextEx(customFont, timeText.c_str(), timeFontSize, 1);
+        texts.time.SetFormatted(customFont, "TEMPO: %03d", (int)view.totalGameTime, timeFontSize, 1);
+        Vector2 timeTextSize = texts.time.Size();
         Color timeColor = UI_TEXT_COLOR;
-        if (totalGameTime < 10 && (int)(GetTime() * 5) % 2 == 0) {
+        if (view.totalGameTime < 10 && (int)(GetTime() * 5) % 2 == 0) {
             timeColor = UI_WARNING_COLOR;
-        } else if (totalGameTime < 20) {
+        } else if (view.totalGameTime < 20) {
             timeColor = CLITERAL(Color){255, 140, 0, 255};
         } else {
             timeColor = UI_TEXT_COLOR;
         }
-        DrawTextEx(customFont, timeText.c_str(), { (SCREEN_WIDTH - timeTextSize.x) / 2.0f, 20 }, timeFontSize, 1, timeColor);
+        texts.time.Draw({ (SCREEN_WIDTH - timeTextSize.x) / 2.0f, 20 }, timeColor);
     }
 
     // Desenha a tela de pausa.
     void DrawPausedScreen() {
         const char* pausedText = "PAUSADO";
         float pausedFontSize = 70;
-        Vector2 pausedTextSize = MeasureTextEx(customFont, pausedText, pausedFontSize, 1);
+        texts.paused.Set(customFont, pausedText, pausedFontSize, 1);
+        Vector2 pausedTextSize = texts.paused.Size();
         float pausedTextY = (SCREEN_HEIGHT / 2.0f - pausedTextSize.y / 2.0f) - 80;
-        DrawTextEx(customFont, pausedText, { (SCREEN_WIDTH - pausedTextSize.x) / 2.0f, pausedTextY }, pausedFontSize, 1, UI_HIGHLIGHT_COLOR);
-
-        float buttonWidth = 300;
-        float buttonHeight = 75;
-        float buttonFontSize = 40;
-        float buttonSpacing = 30;
-        float buttonOverallYOffset = 40.0f;
-
-        float totalButtonsHeight = (buttonHeight * 2) + buttonSpacing;
-        float startY = (SCREEN_HEIGHT - totalButtonsHeight) / 2.0f + buttonOverallYOffset;
-
-        resumeButton.rect.x = (SCREEN_WIDTH - buttonWidth) / 2.0f;
-        resumeButton.rect.y = startY;
-        resumeButton.rect.width = buttonWidth;
-        resumeButton.rect.height = buttonHeight;
-        resumeButton.fontSize = buttonFontSize;
-        resumeButton.Draw(customFont);
+        texts.paused.Draw({ (SCREEN_WIDTH - pausedTextSize.x) / 2.0f, pausedTextY }, UI_HIGHLIGHT_COLOR);
 
-        exitButton.rect.x = (SCREEN_WIDTH - buttonWidth) / 2.0f;
-        exitButton.rect.y = startY + buttonHeight + buttonSpacing;
-        exitButton.rect.width = buttonWidth;
-        exitButton.rect.height = buttonHeight;
-        exitButton.fontSize = buttonFontSize;
+        resumeButton.Draw(customFont);
         exitButton.Draw(customFont);
     }
 
@@ -1010,17 +4156,18 @@ private:
     void DrawLevelTransitionScreen() {
         const char* levelCompleteText = "LEVEL COMPLETO!";
         float completeFontSize = 70;
-        Vector2 levelCompleteTextSize = MeasureTextEx(customFont, levelCompleteText, completeFontSize, 1);
+        texts.levelComplete.Set(customFont, levelCompleteText, completeFontSize, 1);
+        Vector2 levelCompleteTextSize = texts.levelComplete.Size();
         DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(BACKGROUND_DEEPEST_DARK, 0.9f));
 
         float completeTextY = (SCREEN_HEIGHT / 2.0f - levelCompleteTextSize.y / 2.0f) - 50;
-        DrawTextEx(customFont, levelCompleteText, { (SCREEN_WIDTH - levelCompleteTextSize.x) / 2.0f, completeTextY }, completeFontSize, 1, UI_HIGHLIGHT_COLOR);
+        texts.levelComplete.Draw({ (SCREEN_WIDTH - levelCompleteTextSize.x) / 2.0f, completeTextY }, UI_HIGHLIGHT_COLOR);
 
-        const char* nextLevelPrompt = TextFormat("Pressione ENTER para o LEVEL %d", currentLevel + 1);
         float promptFontSize = 35;
-        Vector2 nextLevelPromptSize = MeasureTextEx(customFont, nextLevelPrompt, promptFontSize, 1);
+        texts.nextLevel.SetFormatted(customFont, "Pressione ENTER para o LEVEL %d", simThread.snapshots.Front().currentLevel + 1, promptFontSize, 1);
+        Vector2 nextLevelPromptSize = texts.nextLevel.Size();
         float promptTextY = (SCREEN_HEIGHT / 2.0f - nextLevelPromptSize.y / 2.0f) + 50;
-        DrawTextEx(customFont, nextLevelPrompt, { (SCREEN_WIDTH - nextLevelPromptSize.x) / 2.0f, promptTextY }, promptFontSize, 1, UI_ACCENT_COLOR);
+        texts.nextLevel.Draw({ (SCREEN_WIDTH - nextLevelPromptSize.x) / 2.0f, promptTextY }, UI_ACCENT_COLOR);
     }
 
     // Desenha as telas finais de Vitória ou Game Over.
@@ -1028,30 +4175,414 @@ private:
         DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(BACKGROUND_DEEPEST_DARK, 0.9f));
 
         float titleFontSize = 80;
-        Vector2 titleSize = MeasureTextEx(customFont, title, titleFontSize, 2);
+        texts.endTitle.Set(customFont, title, titleFontSize, 2);
+        Vector2 titleSize = texts.endTitle.Size();
         float titleY = (SCREEN_HEIGHT / 2.0f - titleSize.y / 2.0f) - 120;
-        DrawTextEx(customFont, title, { (SCREEN_WIDTH - titleSize.x) / 2.0f, titleY }, titleFontSize, 2, color);
+        texts.endTitle.Draw({ (SCREEN_WIDTH - titleSize.x) / 2.0f, titleY }, color);
 
-        std::string finalScoreText = TextFormat("SCORE FINAL: %06d", score);
         float scoreFontSize = 50;
-        Vector2 finalScoreTextSize = MeasureTextEx(customFont, finalScoreText.c_str(), scoreFontSize, 1);
+        texts.finalScore.SetFormatted(customFont, "SCORE FINAL: %06d", simThread.snapshots.Front().score, scoreFontSize, 1);
+        Vector2 finalScoreTextSize = texts.finalScore.Size();
         float scoreY = (SCREEN_HEIGHT / 2.0f - scoreFontSize / 2.0f) + 10;
-        DrawTextEx(customFont, finalScoreText.c_str(), { (SCREEN_WIDTH - finalScoreTextSize.x) / 2.0f, scoreY }, scoreFontSize, 1, UI_HIGHLIGHT_COLOR);
+        texts.finalScore.Draw({ (SCREEN_WIDTH - finalScoreTextSize.x) / 2.0f, scoreY }, UI_HIGHLIGHT_COLOR);
 
         const char* pressEnterText = "PRESSIONE ENTER PARA VOLTAR AO MENU";
         float enterFontSize = 25;
-        Vector2 pressEnterTextSize = MeasureTextEx(customFont, pressEnterText, enterFontSize, 1);
+        texts.pressEnter.Set(customFont, pressEnterText, enterFontSize, 1);
+        Vector2 pressEnterTextSize = texts.pressEnter.Size();
         float enterY = (SCREEN_HEIGHT / 2.0f - enterFontSize / 2.0f) + 100;
-        DrawTextEx(customFont, pressEnterText, { (SCREEN_WIDTH - pressEnterTextSize.x) / 2.0f, enterY }, enterFontSize, 1, UI_TEXT_COLOR);
+        texts.pressEnter.Draw({ (SCREEN_WIDTH - pressEnterTextSize.x) / 2.0f, enterY }, UI_TEXT_COLOR);
+    }
+};
+
+// =============================================================================
+//                        EXECUÇÃO HEADLESS (SEM JANELA)
+// =============================================================================
+
+// Bot simples usado nas sessões headless: vai em direção à moeda ativa mais
+// próxima e, depois de coletar todas, em direção ao objetivo. Não desvia das
+// paredes, o que é suficiente para medir balanceamento e detectar regressões.
+static InputState BotInput(const Simulation& sim) {
+    Vector2 self = Simulation::Center(sim.player.rect);
+    Vector2 target = self;
+    float bestDist = -1.0f;
+
+    const auto& collectibles = sim.world.collectibles;
+    for (size_t i = 0; i < collectibles.Size(); i++) {
+        if (collectibles.dense[i].kind != CollectibleKind::COIN || !collectibles.dense[i].active) continue;
+        Vector2 c = Simulation::Center(sim.world.transforms.Get(collectibles.owners[i]).rect);
+        float d = (c.x - self.x) * (c.x - self.x) + (c.y - self.y) * (c.y - self.y);
+        if (bestDist < 0 || d < bestDist) { bestDist = d; target = c; }
     }
+    if (bestDist < 0 && sim.objetivo && sim.objetivo->enabled) target = Simulation::Center(sim.objetivo->rect);
+
+    const float deadZone = 4.0f;
+    InputState input;
+    input.left = target.x < self.x - deadZone;
+    input.right = target.x > self.x + deadZone;
+    input.up = target.y < self.y - deadZone;
+    input.down = target.y > self.y + deadZone;
+    return input;
+}
+
+// Roda 'sessions' partidas completas sem janela nem dispositivo de áudio, com
+// passo fixo de 'delta' segundos, e imprime um resumo no terminal. Retorna o
+// código de saída do processo (1 se algum nível não puder ser carregado).
+static int RunHeadless(int sessions, unsigned int seed, float delta) {
+    int victories = 0;
+    long long totalScore = 0;
+    long long totalTicks = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < sessions; i++) {
+        Simulation sim;
+        bool loaded = sim.StartGame(seed + (unsigned int)i);
+
+        while (loaded) {
+            SimStatus status = sim.Step(BotInput(sim), delta);
+            totalTicks++;
+            if (status == SimStatus::LEVEL_COMPLETE) loaded = sim.NextLevel();
+            else if (status != SimStatus::RUNNING) break;
+        }
+        if (!loaded) {
+            std::cerr << "Falha ao carregar o nivel " << sim.currentLevel << " de " << LevelsDir() << "\n";
+            return 1;
+        }
+
+        if (sim.status == SimStatus::VICTORY) victories++;
+        totalScore += sim.score;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Kernel de paredes: " << wallKernelName << "\n"
+              << "Sessoes: " << sessions << "\n"
+              << "Vitorias: " << victories << " (" << (sessions > 0 ? 100.0 * victories / sessions : 0.0) << "%)\n"
+              << "Pontuacao media: " << (sessions > 0 ? (double)totalScore / sessions : 0.0) << "\n"
+              << "Ticks simulados: " << totalTicks << "\n"
+              << "Tempo: " << seconds << " s (" << (seconds > 0 ? sessions / seconds : 0.0) << " sessoes/s)\n";
+    return 0;
+}
+
+// =============================================================================
+//                              MICRO-BENCHMARKS
+// =============================================================================
+
+// "--bench [saida.json] [filtro]" mede os laços quentes sem janela: colisão
+// contra N paredes, movimento das paredes, emissão e atualização de
+// partículas e ticks completos da simulação em níveis sintéticos. Cada caso
+// repete a operação, dobrando as iterações, até rodar por BENCH_MIN_SECONDS,
+// e informa o tempo por iteração. O JSON segue o formato do Google Benchmark
+// para poder ser comparado entre versões com as mesmas ferramentas.
+static const double BENCH_MIN_SECONDS = 0.25;
+
+struct BenchResult {
+    std::string name;
+    long long iterations;
+    double nsPerIteration;    // Tempo real.
+    double cpuNsPerIteration; // Tempo de CPU do processo, somando todas as threads.
+    double itemsPerSecond;
+};
+
+// Tempo de CPU gasto pelo processo até agora (todas as threads), em segundos.
+static double ProcessCpuSeconds() {
+#if defined(_WIN32)
+    unsigned long long creation, exit, kernel, user; // FILETIME, em unidades de 100 ns.
+    GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+    return (double)(kernel + user) * 1e-7;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+// Cronômetro de um lote de iterações. Pause()/Resume() tiram do tempo real
+// medido a preparação que precisa rodar a cada iteração (ex.: restaurar o
+// estado). Só leem o relógio real, que é barato; o de CPU do processo é uma
+// chamada ao sistema e é lido uma vez por lote, em RunBenchmark.
+class BenchTimer {
+public:
+    void Resume() { wallStart = std::chrono::steady_clock::now(); }
+    void Pause() { wallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count(); }
+
+    double wallSeconds = 0.0;
+    // Itens processados no lote, para os casos em que a quantidade varia; se
+    // ficar em zero, vale itemsPerIteration * iterações.
+    long long items = 0;
+
+private:
+    std::chrono::steady_clock::time_point wallStart;
 };
 
+// Evita que o compilador descarte cálculos cujo resultado não é usado.
+static volatile float benchSink = 0.0f;
+
+// 'body(iterations, timer)' executa a operação 'iterations' vezes com o
+// cronômetro ligado; 'itemsPerIteration' é quantos itens (paredes,
+// partículas, ticks) cada iteração processa.
+template <typename BodyFn>
+static BenchResult RunBenchmark(const std::string& name, long long itemsPerIteration, BodyFn body) {
+    long long iterations = 1;
+    while (true) {
+        BenchTimer timer;
+        auto batchStart = std::chrono::steady_clock::now();
+        double cpuStart = ProcessCpuSeconds();
+        timer.Resume();
+        body(iterations, timer);
+        timer.Pause();
+        double batchCpu = ProcessCpuSeconds() - cpuStart;
+        double batchWall = std::chrono::duration<double>(std::chrono::steady_clock::now() - batchStart).count();
+        double seconds = timer.wallSeconds;
+        if (seconds >= BENCH_MIN_SECONDS || iterations >= (1LL << 40)) {
+            // Se o corpo pausou o cronômetro, o tempo de CPU do lote inclui a
+            // preparação; fica só a fração correspondente ao tempo medido.
+            double cpu = batchWall > 0 ? batchCpu * std::min(1.0, seconds / batchWall) : batchCpu;
+            long long items = timer.items > 0 ? timer.items : itemsPerIteration * iterations;
+            return { name, iterations, seconds * 1e9 / iterations, cpu * 1e9 / iterations, items / seconds };
+        }
+        double scale = seconds > 0 ? BENCH_MIN_SECONDS / seconds * 1.2 : 10.0;
+        iterations = std::max(iterations * 2, (long long)(iterations * std::min(scale, 100.0)));
+    }
+}
+
+// Nível gerado com paredes e moedas espalhadas pela tela, para medir a
+// simulação com quantidades de entidades maiores que as dos níveis reais.
+static LevelData MakeSyntheticLevel(int wallCount, int coinCount, uint32_t seed) {
+    Random rng(seed);
+    LevelData level;
+    for (int i = 0; i < wallCount; i++) {
+        float w = (float)rng.Int(10, 60), h = (float)rng.Int(10, 60);
+        level.walls.Add((float)rng.Int(0, SCREEN_WIDTH - (int)w), (float)rng.Int(0, SCREEN_HEIGHT - (int)h), w, h,
+                        (float)rng.Int(-200, 200), (float)rng.Int(-200, 200), i % 8 == 0 ? WallKind::ESPECIAL : WallKind::NORMAL);
+    }
+    for (int i = 0; i < coinCount; i++) {
+        level.coins.push_back({ (float)rng.Int(20, SCREEN_WIDTH - 20), (float)rng.Int(20, SCREEN_HEIGHT - 20) });
+    }
+    level.powerups = { PowerUpType::LIFE, PowerUpType::SHIELD, PowerUpType::SPEED };
+    return level;
+}
+
+static std::vector<BenchResult> RunBenchmarks(const std::string& filter) {
+    std::vector<BenchResult> results;
+    auto wanted = [&](const std::string& name) { return filter.empty() || name.find(filter) != std::string::npos; };
+    const float delta = 1.0f / DEFAULT_TICK_RATE;
+    const Rectangle player = { SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f, 30, 30 };
+    // Os casos "...Jobs" repetem os anteriores dividindo o trabalho entre as threads do pool.
+    JobSystem jobs;
+
+    for (int n : { 100, 1000, 10000, 100000 }) {
+        LevelData level = MakeSyntheticLevel(n, 0, 1);
+        WallStore& walls = level.walls;
+
+        // Varredura ingênua: um CheckCollisionRecs por parede.
+        std::string name = "BM_CollisionScan/" + std::to_string(n);
+        if (wanted(name)) {
+            results.push_back(RunBenchmark(name, n, [&](long long iterations, BenchTimer&) {
+                int hits = 0;
+                for (long long it = 0; it < iterations; it++) {
+                    for (size_t i = 0; i < walls.Size(); i++) hits += CheckCollisionRecs(player, walls.Rect(i)) ? 1 : 0;
+                }
+                benchSink = benchSink + (float)hits;
+            }));
+        }
+
+        // Movimento + colisão de todas as paredes com o kernel SIMD selecionado.
+        name = std::string("BM_WallUpdate/") + std::to_string(n);
+        if (wanted(name)) {
+            results.push_back(RunBenchmark(name, n, [&](long long iterations, BenchTimer&) {
+                int hits = 0;
+                for (long long it = 0; it < iterations; it++) hits += walls.UpdateAndCollide(delta, player, player);
+                benchSink = benchSink + (float)hits;
+            }));
+        }
+
+        name = std::string("BM_WallUpdateJobs/") + std::to_string(n);
+        if (wanted(name)) {
+            results.push_back(RunBenchmark(name, n, [&](long long iterations, BenchTimer&) {
+                int hits = 0;
+                for (long long it = 0; it < iterations; it++) hits += walls.UpdateAndCollide(delta, player, player, &jobs);
+                benchSink = benchSink + (float)hits;
+            }));
+        }
+    }
+
+    for (int n : { 1000, 10000, 100000, 1000000 }) {
+        // Emissão em um pool vazio: ele é esvaziado fora da medição antes de
+        // cada iteração, para nenhuma emissão cair no caminho de pool cheio.
+        std::string name = "BM_ParticleEmit/" + std::to_string(n);
+        if (wanted(name)) {
+            ParticleSystem particles((size_t)n);
+            results.push_back(RunBenchmark(name, n, [&](long long iterations, BenchTimer& timer) {
+                for (long long it = 0; it < iterations; it++) {
+                    timer.Pause();
+                    particles.Clear();
+                    timer.Resume();
+                    particles.Emit({ 640, 480 }, n, WHITE, 100);
+                }
+                benchSink = benchSink + (float)particles.Count();
+            }));
+        }
+
+        // Emissão com o pool sempre cheio: toda partícula substitui outra
+        // (ParticleOverflow::OVERWRITE_ROUND_ROBIN).
+        name = "BM_ParticleEmit/" + std::to_string(n) + "/overflow";
+        if (wanted(name)) {
+            ParticleSystem particles((size_t)n);
+            particles.Emit({ 640, 480 }, n, WHITE, 100);
+            results.push_back(RunBenchmark(name, n, [&](long long iterations, BenchTimer&) {
+                for (long long it = 0; it < iterations; it++) particles.Emit({ 640, 480 }, n, WHITE, 100);
+                benchSink = benchSink + (float)particles.Count();
+            }));
+        }
+
+        // Passo pequeno para as partículas viverem por muitas iterações; as
+        // que morrem são repostas fora da medição, então cada Update()
+        // processa exatamente 'n' partículas. Os itens são as partículas
+        // realmente atualizadas (Count() antes de cada Update()).
+        for (bool useJobs : { false, true }) {
+            name = (useJobs ? "BM_ParticleUpdateJobs/" : "BM_ParticleUpdate/") + std::to_string(n);
+            if (!wanted(name)) continue;
+            ParticleSystem particles((size_t)n);
+            results.push_back(RunBenchmark(name, n, [&](long long iterations, BenchTimer& timer) {
+                for (long long it = 0; it < iterations; it++) {
+                    if (particles.Count() < (size_t)n) {
+                        timer.Pause();
+                        particles.Emit({ 640, 480 }, n - (int)particles.Count(), WHITE, 100);
+                        timer.Resume();
+                    }
+                    timer.items += (long long)particles.Count();
+                    particles.Update(1e-6f, useJobs ? &jobs : nullptr);
+                }
+                benchSink = benchSink + (float)particles.Count();
+            }));
+        }
+    }
+
+    // Ticks completos da simulação. Cada iteração é o primeiro tick do nível
+    // recém-carregado: a restauração fica fora da medição, então o trabalho
+    // medido não diminui conforme as moedas são coletadas.
+    for (int n : { 100, 1000, 10000, 100000 }) {
+        for (bool useJobs : { false, true }) {
+            std::string name = (useJobs ? "BM_SimulationTickJobs/" : "BM_SimulationTick/") + std::to_string(n);
+            if (!wanted(name)) continue;
+            LevelData level = MakeSyntheticLevel(n, n / 10, 2);
+            Simulation sim;
+            sim.jobs = useJobs ? &jobs : nullptr;
+            LevelData copy;
+            auto reset = [&] {
+                copy = level; // LoadLevel consome os arrays de paredes.
+                sim.rng.Seed(1, RandomStream::GAMEPLAY);
+                sim.totalGameTime = sim.initialGameTime;
+                sim.score = 0;
+                sim.status = SimStatus::RUNNING;
+                sim.LoadLevel(1, &copy);
+            };
+            results.push_back(RunBenchmark(name, 1, [&](long long iterations, BenchTimer& timer) {
+                int score = 0;
+                for (long long it = 0; it < iterations; it++) {
+                    timer.Pause();
+                    reset();
+                    timer.Resume();
+                    sim.Step(BotInput(sim), delta);
+                    score += sim.score;
+                }
+                benchSink = benchSink + (float)score;
+            }));
+        }
+    }
+    return results;
+}
+
+static void PrintBenchResults(const std::vector<BenchResult>& results) {
+    std::cout << "Kernel de paredes: " << wallKernelName << "\n";
+    for (const BenchResult& r : results) {
+        std::cout << r.name << std::string(r.name.size() < 28 ? 28 - r.name.size() : 1, ' ')
+                  << r.nsPerIteration << " ns/iter (cpu " << r.cpuNsPerIteration << "), " << r.iterations << " iteracoes, "
+                  << r.itemsPerSecond / 1e6 << " M itens/s\n";
+    }
+}
+
+// Grava os resultados no formato JSON do Google Benchmark.
+static bool WriteBenchJson(const std::vector<BenchResult>& results, const char* path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "{\n  \"context\": { \"executable\": \"game\", \"wall_kernel\": \"" << wallKernelName
+        << "\", \"num_cpus\": " << std::thread::hardware_concurrency() << " },\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << "    { \"name\": \"" << r.name << "\", \"run_type\": \"iteration\", \"iterations\": " << r.iterations
+            << ", \"real_time\": " << r.nsPerIteration << ", \"cpu_time\": " << r.cpuNsPerIteration
+            << ", \"time_unit\": \"ns\", \"items_per_second\": " << r.itemsPerSecond << " }"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return (bool)out;
+}
+
 // =============================================================================
 //                             FUNÇÃO PRINCIPAL (main)
 // =============================================================================
 // O ponto de entrada do programa, em que o game é instanciado e executado.
-int main() {
-    Game game;
+// Com "--headless [sessoes] [seed]" roda apenas a simulação, sem abrir janela.
+int main(int argc, char** argv) {
+    // "--build-level entrada.txt saida.lvl" converte um nível de texto para binário.
+    if (argc > 3 && std::string(argv[1]) == "--build-level") {
+        LevelData level;
+        if (!ParseLevelText(argv[2], level)) {
+            std::cerr << "Falha ao ler " << argv[2] << "\n";
+            return 1;
+        }
+        if (!WriteLevelBinary(level, argv[3])) {
+            std::cerr << "Falha ao gravar " << argv[3] << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    // "--build-pack pasta saida.pak" empacota os recursos de uma pasta.
+    if (argc > 3 && std::string(argv[1]) == "--build-pack") {
+        if (!WriteAssetPack(argv[2], argv[3])) {
+            std::cerr << "Falha ao gravar " << argv[3] << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    // "--tick-rate N" altera a frequência da simulação e "--fps N" o limite de
+    // frames do desenho (0 = sem limite). Como a simulação tem thread própria,
+    // a frequência dela pode ser maior que a da tela.
+    float tickRate = DEFAULT_TICK_RATE;
+    int targetFps = 60;
+    for (int i = 1; i + 1 < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--tick-rate") tickRate = (float)std::atof(argv[++i]);
+        else if (arg == "--fps") targetFps = std::atoi(argv[++i]);
+    }
+    if (tickRate <= 0.0f) tickRate = DEFAULT_TICK_RATE;
+
+    // "--bench [saida.json] [filtro]" roda os micro-benchmarks sem janela.
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        std::vector<BenchResult> results = RunBenchmarks(argc > 3 ? argv[3] : "");
+        PrintBenchResults(results);
+        if (argc > 2 && argv[2][0] != '\0' && !WriteBenchJson(results, argv[2])) {
+            std::cerr << "Falha ao gravar " << argv[2] << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    // "--replay arquivo" reproduz uma partida gravada e confere o resultado.
+    if (argc > 2 && std::string(argv[1]) == "--replay") {
+        return RunReplayCheck(argv[2]);
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--headless") {
+        int sessions = argc > 2 && argv[2][0] != '-' ? std::atoi(argv[2]) : 1000;
+        unsigned int seed = argc > 3 && argv[3][0] != '-' ? (unsigned int)std::strtoul(argv[3], nullptr, 10) : 1;
+        return RunHeadless(sessions, seed, 1.0f / tickRate);
+    }
+
+    Game game(tickRate, targetFps);
     game.Run();
     return 0;
 }
\ No newline at end of file